@@ -8,14 +8,71 @@
 
 #pragma once
 
+#include "simdvec.h"    // for simd::F64vec8, simd::F64vec4, simd::F64vec2
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <type_traits>  // for std::decay_t, std::false_type, std::integral_constant, std::is_convertible, std::true_type
+#include <utility>      // for std::declval, std::forward, std::move
+
 namespace myfunctional {
+    // #region 被積分関数の形の判定
+
+    //! A template struct.
+    /*!
+        SFINAEで式の妥当性を判定するための補助
+    */
+    template <typename...>
+    struct voider {
+        using type = void;
+    };
+
+    //! A template struct.
+    /*!
+        FUNCTYPEがT型の引数一つで呼び出せて、戻り値がR型に変換できるかどうか
+    */
+    template <typename FUNCTYPE, typename T, typename R, typename = void>
+    struct is_callable : std::false_type {};
+
+    //! A template struct.
+    /*!
+        FUNCTYPEがT型の引数一つで呼び出せて、戻り値がR型に変換できるかどうか
+    */
+    template <typename FUNCTYPE, typename T, typename R>
+    struct is_callable<FUNCTYPE, T, R, typename voider<decltype(std::declval<FUNCTYPE const &>()(std::declval<T const &>()))>::type>
+        : std::is_convertible<decltype(std::declval<FUNCTYPE const &>()(std::declval<T const &>())), R> {};
+
+    //! A template struct.
+    /*!
+        FUNCTYPEが、n個のxの値の配列からn個のf(x)の値の配列を求める形
+        func(double const * x, double * y, std::size_t n)で呼び出せるかどうか
+    */
+    template <typename FUNCTYPE, typename = void>
+    struct has_batch : std::false_type {};
+
+    //! A template struct.
+    /*!
+        FUNCTYPEが、n個のxの値の配列からn個のf(x)の値の配列を求める形
+        func(double const * x, double * y, std::size_t n)で呼び出せるかどうか
+    */
+    template <typename FUNCTYPE>
+    struct has_batch<FUNCTYPE, typename voider<decltype(std::declval<FUNCTYPE const &>()(std::declval<double const *>(), std::declval<double *>(), std::declval<std::size_t>()))>::type>
+        : std::true_type {};
+
+    // #endregion 被積分関数の形の判定
+
     //! A template class.
     /*!
         std::function<double (double)>の代わりになるtemplate class
+        関数は値で保持するので、一時オブジェクトから作ってもよい
+        FUNCTYPEはdoubleを引数に取る形か、配列をまとめて評価する形（func(double const *, double *, std::size_t)）の少なくとも一方を持たなければならない
+        配列をまとめて評価する形を持つときは、Gauss_Legendre::qgaussはその形で節をまとめて渡す
     */
     template <typename FUNCTYPE>
     class Functional final
     {
+        static_assert(is_callable<FUNCTYPE, double, double>::value || has_batch<FUNCTYPE>::value,
+            "FUNCTYPE must be callable as double(double) or as void(double const *, double *, std::size_t)");
+
     public:
         // #region コンストラクタ
 
@@ -23,7 +80,13 @@ namespace myfunctional {
         /*!
         \param func operator()で呼び出す関数
         */
-        Functional(const FUNCTYPE & func) : func_(func) {}
+        Functional(FUNCTYPE const & func) : func_(func) {}
+
+        //! A constructor.
+        /*!
+        \param func operator()で呼び出す関数
+        */
+        Functional(FUNCTYPE && func) : func_(std::move(func)) {}
 
         // #endregion コンストラクタ
 
@@ -38,19 +101,162 @@ namespace myfunctional {
         */
         double operator()(double x) const
         {
-            return func_(x);
+            return scalar(x, std::integral_constant<bool, is_callable<FUNCTYPE, double, double>::value>());
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            関数f(x)の値を、xの各要素について求めて返す
+            \param x xの値
+            \return f(x)の値
+        */
+        SIMD_FORCEINLINE simd::F64vec8 operator()(simd::F64vec8 const & x) const
+        {
+            if (BATCH) {
+                return lanes(x);
+            }
+
+            return simd::F64vec8(
+                (*this)(x[7]), (*this)(x[6]), (*this)(x[5]), (*this)(x[4]),
+                (*this)(x[3]), (*this)(x[2]), (*this)(x[1]), (*this)(x[0]));
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            関数f(x)の値を、xの各要素について求めて返す
+            \param x xの値
+            \return f(x)の値
+        */
+        SIMD_FORCEINLINE simd::F64vec4 operator()(simd::F64vec4 const & x) const
+        {
+            if (BATCH) {
+                return lanes(x);
+            }
+
+            return simd::F64vec4((*this)(x[3]), (*this)(x[2]), (*this)(x[1]), (*this)(x[0]));
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            関数f(x)の値を、xの各要素について求めて返す
+            \param x xの値
+            \return f(x)の値
+        */
+        SIMD_FORCEINLINE simd::F64vec2 operator()(simd::F64vec2 const & x) const
+        {
+            if (BATCH) {
+                return lanes(x);
+            }
+
+            return simd::F64vec2((*this)(x[1]), (*this)(x[0]));
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            n個のxの値について、関数f(x)の値をまとめて求める
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * x, double * y, std::size_t n) const
+        {
+            batch(x, y, n, std::integral_constant<bool, BATCH>());
         }
 
         // #endregion メンバ関数
 
+        // #region メンバ変数
+
+        //! A public static member variable (constant).
+        /*!
+            FUNCTYPEが配列をまとめて評価する形を持つかどうか
+        */
+        static bool constexpr BATCH = has_batch<FUNCTYPE>::value;
+
+        // #endregion メンバ変数
+
     private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            FUNCTYPEの配列をまとめて評価する形を呼び出す
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void batch(double const * x, double * y, std::size_t n, std::true_type) const
+        {
+            func_(x, y, n);
+        }
+
+        //! A private member function.
+        /*!
+            FUNCTYPEが配列をまとめて評価する形を持たないので、xの値を一つずつ評価する
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void batch(double const * x, double * y, std::size_t n, std::false_type) const
+        {
+            for (std::size_t i = 0; i < n; i++) {
+                y[i] = func_(x[i]);
+            }
+        }
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの要素を配列に書き出して、配列をまとめて評価する形で求める
+            \param x xの値
+            \return f(x)の値
+        */
+        template <typename VEC>
+        SIMD_FORCEINLINE VEC lanes(VEC const & x) const
+        {
+            static auto constexpr W = sizeof(VEC) / sizeof(double);
+            std::array<double, W> in, out;
+            x.storeu(in.data());
+            (*this)(in.data(), out.data(), W);
+            return VEC::loadu(out.data());
+        }
+
+        //! A private member function.
+        /*!
+            FUNCTYPEのdoubleを引数に取る形を呼び出す
+            \param x xの値
+            \return f(x)の値
+        */
+        double scalar(double x, std::true_type) const
+        {
+            return func_(x);
+        }
+
+        //! A private member function.
+        /*!
+            FUNCTYPEがdoubleを引数に取る形を持たないので、要素数1の配列として評価する
+            \param x xの値
+            \return f(x)の値
+        */
+        double scalar(double x, std::false_type) const
+        {
+            auto y = 0.0;
+            func_(&x, &y, 1);
+            return y;
+        }
+
+        // #endregion メンバ関数
+
         // #region メンバ変数
-        
-        //! A private const variable (reference).
+
+        //! A private member variable.
         /*!
             operator()で呼び出す関数
         */
-        const FUNCTYPE & func_;
+        FUNCTYPE func_;
 
         // #endregion メンバ変数
     };
@@ -62,9 +268,200 @@ namespace myfunctional {
         \return 生成されたFunction<FUNCTYPE>
     */
     template <typename FUNCTYPE>
-    Functional<FUNCTYPE> make_functional(const FUNCTYPE & func)
+    Functional<std::decay_t<FUNCTYPE>> make_functional(FUNCTYPE && func)
+    {
+        return Functional<std::decay_t<FUNCTYPE>>(std::forward<FUNCTYPE>(func));
+    }
+
+    //! A template class.
+    /*!
+        SIMDベクトル（simd::F64vec8, simd::F64vec4, simd::F64vec2）をまとめて評価できる被積分関数のためのtemplate class
+        関数は値で保持するので、一時オブジェクトから作ってもよい
+        FUNCTYPEはdoubleとSIMDベクトルの両方を引数に取れなければならない
+        Gauss_Legendre_Floatで使うときは、floatと単精度のSIMDベクトル（simd::F32vec16, simd::F32vec8, simd::F32vec4）も引数に取れなければならない
+        配列をまとめて評価する形（func(double const *, double *, std::size_t)）も持つときは、Gauss_Legendre::qgaussはその形を優先する
+    */
+    template <typename FUNCTYPE>
+    class VectorFunctional final
+    {
+        static_assert(is_callable<FUNCTYPE, double, double>::value, "FUNCTYPE must be callable as double(double)");
+
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+        \param func operator()で呼び出す関数
+        */
+        VectorFunctional(FUNCTYPE const & func) : func_(func) {}
+
+        //! A constructor.
+        /*!
+        \param func operator()で呼び出す関数
+        */
+        VectorFunctional(FUNCTYPE && func) : func_(std::move(func)) {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            operator()の宣言と実装
+            関数f(x)の値を、xの各要素についてまとめて返す
+            \param x xの値（doubleまたはSIMDベクトル）
+            \return f(x)の値
+        */
+        template <typename T>
+        T operator()(T const & x) const
+        {
+            return func_(x);
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            n個のxの値について、関数f(x)の値をまとめて求める
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * x, double * y, std::size_t n) const
+        {
+            batch(x, y, n, std::integral_constant<bool, BATCH>());
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant).
+        /*!
+            FUNCTYPEが配列をまとめて評価する形を持つかどうか
+        */
+        static bool constexpr BATCH = has_batch<FUNCTYPE>::value;
+
+        // #endregion メンバ変数
+
+    private:
+        // #region メンバ関数
+
+        //! A private member function.
+        /*!
+            FUNCTYPEの配列をまとめて評価する形を呼び出す
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void batch(double const * x, double * y, std::size_t n, std::true_type) const
+        {
+            func_(x, y, n);
+        }
+
+        //! A private member function.
+        /*!
+            FUNCTYPEが配列をまとめて評価する形を持たないので、xの値を一つずつ評価する
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void batch(double const * x, double * y, std::size_t n, std::false_type) const
+        {
+            for (std::size_t i = 0; i < n; i++) {
+                y[i] = func_(x[i]);
+            }
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            operator()で呼び出す関数
+        */
+        FUNCTYPE func_;
+
+        // #endregion メンバ変数
+    };
+
+    //! A template function（非メンバ関数）.
+    /*!
+        VectorFunctional<FUNCTYPE>を生成する
+        \param func 格納する関数
+        \return 生成されたVectorFunctional<FUNCTYPE>
+    */
+    template <typename FUNCTYPE>
+    VectorFunctional<std::decay_t<FUNCTYPE>> make_vectorfunctional(FUNCTYPE && func)
+    {
+        return VectorFunctional<std::decay_t<FUNCTYPE>>(std::forward<FUNCTYPE>(func));
+    }
+
+    //! A template class.
+    /*!
+        一つの節についてK個の値を返す被積分関数のためのtemplate class
+        関数は値で保持するので、一時オブジェクトから作ってもよい
+        FUNCTYPEはdoubleとSIMDベクトルの両方を引数に取り、引数と同じ型のK要素のstd::arrayを返さなければならない
+    */
+    template <typename FUNCTYPE, std::size_t K>
+    class MultiFunctional final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+        \param func operator()で呼び出す関数
+        */
+        MultiFunctional(FUNCTYPE const & func) : func_(func) {}
+
+        //! A constructor.
+        /*!
+        \param func operator()で呼び出す関数
+        */
+        MultiFunctional(FUNCTYPE && func) : func_(std::move(func)) {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            operator()の宣言と実装
+            K個の関数f_k(x)の値を、xの各要素についてまとめて返す
+            \param x xの値（doubleまたはSIMDベクトル）
+            \return f_k(x)の値
+        */
+        template <typename T>
+        std::array<T, K> operator()(T const & x) const
+        {
+            return func_(x);
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            operator()で呼び出す関数
+        */
+        FUNCTYPE func_;
+
+        // #endregion メンバ変数
+    };
+
+    //! A template function（非メンバ関数）.
+    /*!
+        MultiFunctional<FUNCTYPE, K>を生成する
+        \param func 格納する関数
+        \return 生成されたMultiFunctional<FUNCTYPE, K>
+    */
+    template <std::size_t K, typename FUNCTYPE>
+    MultiFunctional<std::decay_t<FUNCTYPE>, K> make_multifunctional(FUNCTYPE && func)
     {
-        return Functional<FUNCTYPE>(func);
+        return MultiFunctional<std::decay_t<FUNCTYPE>, K>(std::forward<FUNCTYPE>(func));
     }
 }
 
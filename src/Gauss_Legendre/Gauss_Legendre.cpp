@@ -3,51 +3,92 @@
 
     Copyright ©  2014 @dc1394 All Rights Reserved.
 */
-#include "gauss_legendre.h"
-#include "integration.h"
-#include <array>        // for std::array
+#include "Gauss_Legendre.h"
+#include "rulefile.h"
+#include "ruleregistry.h"
 #include <stdexcept>    // for std::runtime_error
-#include <immintrin.h>  // for _xgetbv
-#include <intrin.h>     // for __cpuid
+#include <utility>      // for std::move
 
 namespace gausslegendre {
-    Gauss_Legendre::Gauss_Legendre(std::uint32_t n)
-        : avxSupported(availableAVX()), n_(n)
+    namespace {
+        //! A function.
+        /*!
+            ファイルから節と重みのテーブルを読み込む（ファイルが存在しなければ計算する）
+            \param path ファイルのパス
+            \param n Gauss-Legendreの分点
+            \param storage 節と重みの格納方法
+            \param verify 節と重みのチェックサムを確かめるかどうか
+            \return 節と重みのテーブル
+        */
+        std::shared_ptr<NodeTable const> loadOrMakeNodeTable(std::string const & path, std::uint32_t n, Storage storage, bool verify)
+        {
+            auto table = loadNodeTable(path, n, storage, verify);
+            return table ? std::move(table) : nodeTable(n, storage);
+        }
+    }
+
+    Gauss_Legendre::Gauss_Legendre(std::uint32_t n, Kernel kernel, Summation summation, Storage storage, Execution execution)
+        : Gauss_Legendre(nodeTable(n, storage), n, kernel, summation, storage, execution)
+    {
+    }
+
+    Gauss_Legendre::Gauss_Legendre(std::string const & path, std::uint32_t n, Kernel kernel, Summation summation, Storage storage, Execution execution, bool verify)
+        : Gauss_Legendre(loadOrMakeNodeTable(path, n, storage, verify), n, kernel, summation, storage, execution)
+    {
+    }
+
+    Gauss_Legendre::Gauss_Legendre(std::shared_ptr<NodeTable const> && table, std::uint32_t n, Kernel kernel, Summation summation, Storage storage, Execution execution)
+        : execution_(execution),
+          kernel_(kernel == Kernel::Auto ? bestKernel() : kernel),
+          summation_(summation),
+          n_(n),
+          storage_(storage),
+          table_(std::move(table))
     {
-        alglib::ae_int_t info = 0;
-        alglib::real_1d_array x, w;
-        alglib::gqgenerategausslegendre(n, info, x, w);
-        switch (info) {
-        case 1:
-            break;
-
-        default:
-            throw std::runtime_error("alglib::gqgenerategausslegendreが失敗");
-            break;
+        if (!availableKernel(kernel_)) {
+            throw std::runtime_error(std::string(kernelName(kernel_)) + "カーネルはこのCPUでは使用できない");
         }
 
-        x_.assign(x.getcontent(), x.getcontent() + x.length());
-        x2_.assign(x_.begin(), x_.end());
-        w_.assign(w.getcontent(), w.getcontent() + w.length());
-        w2_.assign(w_.begin(), w_.end());
+        dispatch_ = dispatchIndex(kernel_, static_cast<std::uint32_t>(summation_) * 2 + (storage_ == Storage::Symmetric ? 1 : 0));
     }
 
-    
-    bool Gauss_Legendre::availableAVX() const
+    Plan Gauss_Legendre::plan(double x1, double x2) const
     {
-        std::array<std::int32_t, 4> cpuInfo = { 0 };
-        __cpuid(cpuInfo.data(), 1);
+        return Plan(*table_, storage_, kernel_, summation_, x1, x2);
+    }
 
-        auto const osUsesXSAVE_XRSTORE = cpuInfo[2] & (1 << 27) || false;
-        auto const cpuAVXSuport = cpuInfo[2] & (1 << 28) || false;
+#ifdef SIMD_MSVC
+    // 補正付きの和は、/fp:fastでコンパイルしても式を並べ替えさせない
+    #pragma float_control(precise, on, push)
+#endif
 
-        if (osUsesXSAVE_XRSTORE && cpuAVXSuport)
-        {
-            // Check if the OS will save the YMM registers
-            auto const xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
-            return (xcrFeatureMask & 0x6) || false;
+    double Gauss_Legendre::reduce(double const * partial, std::size_t count) const
+    {
+        if (summation_ != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (std::size_t i = 0; i < count; i++) {
+                auto e = 0.0;
+                hi = simd::twosum(hi, partial[i], e);
+                lo += e;
+            }
+
+            return hi + lo;
+        }
+
+        auto sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += partial[i];
         }
 
-        return false;
+        return sum;
+    }
+
+#ifdef SIMD_MSVC
+    #pragma float_control(pop)
+#endif
+
+    void Gauss_Legendre::save(std::string const & path) const
+    {
+        saveNodeTable(path, *table_, n_, storage_);
     }
 }
@@ -8,15 +8,26 @@
 
 #pragma once
 
-#include "functional.h"
-#include <array>                            // for std::array
-#include <cstdint>                          // for std::int32_t
-#include <vector>                           // for std::vector
-#include <intrin.h>                         // for _xgetbv
-#include <boost/align/aligned_allocator.hpp>// for boost::alignment::aligned_allocator
-#include <dvec.h>                           // for F64vec4, F64vec2
+#include "Functional.h"
+#include "integrand.h"
+#include "kernel.h"
+#include "nodetable.h"
+#include "plan.h"
+#include "simdvec.h"    // for simd::F64vec8, simd::F64vec4, simd::F64vec2
+#include "summation.h"
+#include <algorithm>    // for std::min
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <memory>       // for std::shared_ptr
+#include <string>       // for std::string
+#include <type_traits>  // for std::integral_constant
+#include <utility>      // for std::index_sequence, std::make_index_sequence
+#include <vector>       // for std::vector
 
 namespace gausslegendre {
+    class GaussRule;
+
     //! A class.
     /*!
         Gauss-Legendre積分を行うクラス
@@ -28,170 +39,1700 @@ namespace gausslegendre {
 
         //! A constructor.
         /*!
-            唯一のコンストラクタ
-            Gauss-Legendreの重みと節を計算して、それぞれw_とx_に格納する
+            Gauss-Legendreの重みと節のテーブルを取得して、table_に格納する
+            同じ分点と格納方法のテーブルは、プロセス全体で一度だけ計算されて共有される
+            使用する積分カーネルはここで一度だけ決定される
+            \param n Gauss-Legendreの分点
+            \param kernel 使用する積分カーネル（Kernel::Autoなら最良のものを自動で選ぶ）
+            \param summation 重み付きの和を求める方法
+            \param storage 節と重みの格納方法
+            \param execution 一回の積分の実行方法（Execution::Parallelのとき、被積分関数はスレッドセーフであること）
+        */
+        explicit Gauss_Legendre(std::uint32_t n, Kernel kernel = Kernel::Auto, Summation summation = Summation::Naive, Storage storage = Storage::Full, Execution execution = Execution::Sequential);
+
+        //! A constructor.
+        /*!
+            save()で保存したファイルをメモリマップして、Gauss-Legendreの重みと節のテーブルとする（コピーはしない）
+            ファイルが存在しなければ、ファイルを使わないコンストラクタと同じように重みと節を計算する
+            \param path ファイルのパス
             \param n Gauss-Legendreの分点
+            \param kernel 使用する積分カーネル（Kernel::Autoなら最良のものを自動で選ぶ）
+            \param summation 重み付きの和を求める方法
+            \param storage 節と重みの格納方法
+            \param execution 一回の積分の実行方法（Execution::Parallelのとき、被積分関数はスレッドセーフであること）
+            \param verify ファイルの節と重みのチェックサムを確かめるかどうか（確かめるとファイル全体を読む）
+            \throw std::runtime_error ファイルが壊れているか、nやstorageが一致しないとき
+        */
+        Gauss_Legendre(std::string const & path, std::uint32_t n, Kernel kernel = Kernel::Auto, Summation summation = Summation::Naive, Storage storage = Storage::Full, Execution execution = Execution::Sequential, bool verify = false);
+
+        //! A copy constructor.
+        /*!
+            コピーコンストラクタ
+            節と重みのテーブルは変更されないので、共有するだけである
+        */
+        Gauss_Legendre(Gauss_Legendre const &) = default;
+
+        //! A move constructor.
+        /*!
+            ムーブコンストラクタ
         */
-        explicit Gauss_Legendre(std::uint32_t n);
+        Gauss_Legendre(Gauss_Legendre &&) = default;
 
         // #endregion コンストラクタ
 
         // #region メンバ関数
 
+        //! A public member function.
+        /*!
+            operator=()の宣言（コピー代入演算子）
+            \param コピー元のオブジェクト
+            \return このオブジェクト
+        */
+        Gauss_Legendre & operator=(Gauss_Legendre const &) = default;
+
+        //! A public member function.
+        /*!
+            operator=()の宣言（ムーブ代入演算子）
+            \param ムーブ元のオブジェクト
+            \return このオブジェクト
+        */
+        Gauss_Legendre & operator=(Gauss_Legendre &&) = default;
+
         //! A public member function (template function).
         /*!
             Gauss-Legendre積分を実行する
             \param func 被積分関数
-            \param usesimd SIMDを使用するかどうか
             \param x1 積分の下端
             \param x2 積分の上端
             \return 積分値
         */
         template <typename FUNCTYPE>
-        double qgauss(myfunctional::Functional<FUNCTYPE> const & func, bool usesimd, double x1, double x2) const;
+        double qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const;
 
-    private:
-        //! A private member function.
+        //! A public member function (template function).
         /*!
-            AVX命令が使用可能かどうかをチェックする
-            \return AVX命令が使用可能ならtrue、使用不可能ならfalse
+            Gauss-Legendre積分を実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
         */
-        bool availableAVX() const;
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const;
 
-        // #endregion メンバ関数
+        //! A public member function.
+        /*!
+            型消去された被積分関数のGauss-Legendre積分を実行する
+            被積分関数には、節をBLOCKSIZE個ずつまとめて渡す
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        double qgauss(myfunctional::Integrand const & func, double x1, double x2) const
+        {
+            return qgaussimpl(myfunctional::make_functional(myfunctional::IntegrandRef(func)), x1, x2);
+        }
 
-        // #region メンバ変数
+        //! A public member function (template function).
+        /*!
+            count個の積分区間[x1[i], x2[i]]について、まとめてGauss-Legendre積分を実行する
+            分点が少ないときは、SIMDベクトルの各要素に別々の積分区間を割り当てる
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <typename FUNCTYPE>
+        void qgauss(myfunctional::Functional<FUNCTYPE> const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
 
-        //! A private member variable (constant).
+        //! A public member function (template function).
         /*!
-            AVX命令が使用可能かどうか
+            count個の積分区間[x1[i], x2[i]]について、まとめてGauss-Legendre積分を実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            分点が少ないときは、SIMDベクトルの各要素に別々の積分区間を割り当てる
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
         */
-        const bool avxSupported;
+        template <typename FUNCTYPE>
+        void qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
 
-        //! A private member variable (constant).
+        //! A public member function (template function).
         /*!
-            Gauss-Legendreの分点
+            積分区間[x1, x2]をpanels個の等しい小区間（パネル）に分け、各パネルにGauss-Legendre積分を適用した和を返す（複合則）
+            パネルはCOMPOSITEBLOCK個ずつまとめて積分するので、分点が少ないときはSIMDベクトルの各要素に別々のパネルが割り当てられる
+            Execution::Parallelのときは、パネルのまとまりをOpenMPで並列に積分する（結果はスレッド数によらない）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param panels パネルの数（0のときは0を返す）
+            \return 積分値
         */
-        const std::uint32_t n_;
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2, std::uint32_t panels) const;
 
-        //! A private member variable.
+        //! A public member function (template function).
         /*!
-            Gauss-Legendreの重み（alignmentが揃っている）
+            積分区間[x1, x2]をpanels個の等しい小区間（パネル）に分け、各パネルにGauss-Legendre積分を適用した和を返す（複合則）
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param panels パネルの数（0のときは0を返す）
+            \return 積分値
         */
-        std::vector<double, boost::alignment::aligned_allocator<__m256d>> w_;
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2, std::uint32_t panels) const;
 
-        //! A private member variable.
+        //! A public member function (template function).
         /*!
-            Gauss-Legendreの重み（alignmentが揃っていない）
+            一つの節についてK個の値を返す被積分関数の、K個の積分をまとめて実行する
+            節の写像と節と重みのテーブルの読み込みは、K個の積分で一度だけ行われる
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取り、同じ型のK要素のstd::arrayを返すもの）
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return K個の積分値
         */
-        std::vector<double> w2_;
+        template <typename FUNCTYPE, std::size_t K>
+        std::array<double, K> qgauss(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double x1, double x2) const;
 
-        //! A private member variable.
+        //! A public member function.
         /*!
-            Gauss-Legendreの節（alignmentが揃っている）
+            積分区間[x1, x2]を固定したプランを作る
+            区間を変えずに被積分関数だけを変えて何度も積分するときは、qgaussの代わりにプランを使う
+            プランはExecutionを引き継がず、一回の積分は常に一つのスレッドで実行する
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分のプラン
         */
-        std::vector<double, boost::alignment::aligned_allocator<__m256d>> x_;
-        
-        //! A private member variable.
+        Plan plan(double x1, double x2) const;
+
+        //! A public member function.
         /*!
-            Gauss-Legendreの節（alignmentが揃っていない）
+            Gauss-Legendreの重みと節のテーブルをファイルに保存する
+            このオブジェクトがマップしているファイル自身に保存してもよい
+            \param path ファイルのパス
+            \throw std::runtime_error 書き込みに失敗したとき
         */
-        std::vector<double> x2_;
-        
-        // #endregion メンバ変数
+        void save(std::string const & path) const;
 
-        // #region 禁止されたコンストラクタ・メンバ関数
+        //! A public member function.
+        /*!
+            一回の積分の実行方法を返す
+            \return 一回の積分の実行方法
+        */
+        Execution execution() const
+        {
+            return execution_;
+        }
 
-        //! A private constructor (deleted).
+        //! A public member function.
         /*!
-            デフォルトコンストラクタ（禁止）
+            使用している積分カーネルを返す
+            \return 使用している積分カーネル
         */
-        Gauss_Legendre() = delete;
+        Kernel kernel() const
+        {
+            return kernel_;
+        }
 
-        //! A private copy constructor (deleted).
+        //! A public member function.
         /*!
-            コピーコンストラクタ（禁止）
+            節と重みの格納方法を返す
+            \return 節と重みの格納方法
         */
-		Gauss_Legendre(Gauss_Legendre const &) = delete;
+        Storage storage() const
+        {
+            return storage_;
+        }
 
-        //! A private member function (deleted).
+        //! A public member function.
         /*!
-            operator=()の宣言（禁止）
-            \param コピー元のオブジェクト
-            \return コピー元のオブジェクト
+            重み付きの和を求める方法を返す
+            \return 重み付きの和を求める方法
         */
-		Gauss_Legendre & operator=(Gauss_Legendre const &) = delete;
+        Summation summation() const
+        {
+            return summation_;
+        }
 
-        // #endregion 禁止されたコンストラクタ・メンバ関数
-	};
+    private:
+        //! A private template alias.
+        /*!
+            節を一次変換で写して重み付きの和を求める関数（qgausssum）へのポインタ
+        */
+        template <typename FUNCTIONAL>
+        using AffineKernel = double (Gauss_Legendre::*)(FUNCTIONAL const &, double, double) const;
 
-	inline bool Gauss_Legendre::availableAVX() const
-	{
-#if (_MSC_FULL_VER >= 160040219)
-        std::array<std::int32_t, 4> cpuInfo = { 0 };
-		::__cpuid(cpuInfo.data(), 1);
- 			
-		auto const osUsesXSAVE_XRSTORE = cpuInfo[2] & (1 << 27) || false;
-		auto const cpuAVXSuport = cpuInfo[2] & (1 << 28) || false;
- 
-		if (osUsesXSAVE_XRSTORE && cpuAVXSuport)
-		{
-			// Check if the OS will save the YMM registers
-			auto const xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
-			return (xcrFeatureMask & 0x6) || false;
-		}
-#endif
-		return false;
-	}
+        //! A private template alias.
+        /*!
+            まとめて積分を行う関数（qgaussbatchkernel, qgaussbatchrepro）へのポインタ
+        */
+        template <typename FUNCTIONAL>
+        using BatchKernel = void (Gauss_Legendre::*)(FUNCTIONAL const &, double const *, double const *, double *, std::size_t) const;
 
-    template <typename FUNCTYPE>
-    inline double Gauss_Legendre::qgauss(myfunctional::Functional<FUNCTYPE> const & func, bool usesimd, double x1, double x2) const
-    {
-        auto const xm = 0.5 * (x1 + x2);
-        auto const xr = 0.5 * (x2 - x1);
+        //! A private template alias.
+        /*!
+            K個の積分をまとめて行う関数（qgaussmultikernel, qgaussmultiscalar）へのポインタ
+        */
+        template <typename FUNCTYPE, std::size_t K>
+        using MultiKernel = std::array<double, K> (Gauss_Legendre::*)(myfunctional::MultiFunctional<FUNCTYPE, K> const &, double, double) const;
 
-        auto sum = 0.0;
-        if (usesimd && avxSupported) {
-            auto const loop = n_ >> 2;
-            for (auto i = 0U; i < loop; i++) {
-                auto const xi(
-                	F64vec4(
-                		_mm256_load_pd(&x_[(i << 2)]) * F64vec4(xr) + F64vec4(xm)));
+        //! A friend class.
+        /*!
+            節と重みのテーブルを渡して、積分カーネルを使う
+        */
+        friend class GaussRule;
 
-                auto const t = F64vec4(func(xi[3]), func(xi[2]), func(xi[1]), func(xi[0]));
-                
-                sum += add_horizontal(F64vec4(_mm256_load_pd(&w_[(i << 2)]) * t));
-            }
+        //! A private constructor.
+        /*!
+            Gauss-Legendreの重みと節のテーブルを受け取るコンストラクタ
+            使用する積分カーネルはここで一度だけ決定される
+            \param table 節と重みのテーブル
+            \param n Gauss-Legendreの分点
+            \param kernel 使用する積分カーネル（Kernel::Autoなら最良のものを自動で選ぶ）
+            \param summation 重み付きの和を求める方法
+            \param storage 節と重みの格納方法
+            \param execution 一回の積分の実行方法
+        */
+        Gauss_Legendre(std::shared_ptr<NodeTable const> && table, std::uint32_t n, Kernel kernel, Summation summation, Storage storage, Execution execution);
 
-            auto const remainder = n_ & 0x03;
-            for (auto i = n_ - remainder; i < n_; i++) {
-                sum += w_[i] * func(xm + xr * x_[i]);
-            }
-        }
-        else if (usesimd) {
-            auto const loop = n_ >> 1;
-            for (auto i = 0U; i < loop; i++) {
-                auto const xi(
-                	F64vec2(
-                		_mm_load_pd(&x_[(i << 1)]) * F64vec2(xr) + F64vec2(xm)));
-                sum += add_horizontal(
-                	F64vec2(
-                		_mm_load_pd(&w_[(i << 1)]) * F64vec2(func(xi[1]), 
-                		func(xi[0]))));
-            }
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字ごとに、qgausssumの実体へのポインタを並べた表を作る
+            \return qgausssumの実体へのポインタの表
+        */
+        template <typename FUNCTIONAL, std::size_t... I>
+        static constexpr std::array<AffineKernel<FUNCTIONAL>, sizeof...(I)> affinetable(std::index_sequence<I...>);
 
-            if (n_ & 0x01) {
-                sum += w_[n_ - 1] * func(xm + xr * x_[n_ - 1]);
-            }
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字Iに対応する、まとめて積分を行う関数へのポインタを返す
+            \return qgaussbatchkernelの実体へのポインタ
+        */
+        template <typename FUNCTIONAL, std::size_t I>
+        static constexpr BatchKernel<FUNCTIONAL> batchentry(std::false_type);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字Iに対応する、まとめて積分を行う関数へのポインタを返す（Summation::Reproducible）
+            \return qgaussbatchreproの実体へのポインタ
+        */
+        template <typename FUNCTIONAL, std::size_t I>
+        static constexpr BatchKernel<FUNCTIONAL> batchentry(std::true_type);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字ごとに、まとめて積分を行う関数へのポインタを並べた表を作る
+            \return まとめて積分を行う関数へのポインタの表
+        */
+        template <typename FUNCTIONAL, std::size_t... I>
+        static constexpr std::array<BatchKernel<FUNCTIONAL>, sizeof...(I)> batchtable(std::index_sequence<I...>);
+
+        //! A private static member function.
+        /*!
+            積分カーネルの表の添字から、重み付きの和を求める方法を求める
+            \param index 積分カーネルの表の添字
+            \return 重み付きの和を求める方法
+        */
+        static constexpr Summation dispatchsummation(std::size_t index)
+        {
+            return static_cast<Summation>(dispatchVariant(index) / 2);
         }
-        else {
-            for (auto i = 0U; i < n_; i++) {
-                auto const xi = xm + xr * x2_[i];
-                sum += w2_[i] * func(xi);
-            }
+
+        //! A private static member function.
+        /*!
+            積分カーネルの表の添字から、節と重みの格納方法がStorage::Symmetricかどうかを求める
+            \param index 積分カーネルの表の添字
+            \return Storage::Symmetricならtrue
+        */
+        static constexpr bool dispatchsymmetric(std::size_t index)
+        {
+            return dispatchVariant(index) % 2 != 0;
         }
 
-        return sum * xr;
+        //! A private static member function (template function).
+        /*!
+            節xに対応する被積分関数の値を返す
+            SYMMETRICのときはf(xm + xr * x) + f(xm - xr * x)を返す
+            \param func 被積分関数
+            \param x 節（doubleまたはSIMDベクトル）
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param usefma FMAを使うかどうか
+            \return 被積分関数の値
+        */
+        template <bool SYMMETRIC, typename FUNCTIONAL, typename VEC, typename USEFMA>
+        static SIMD_FORCEINLINE VEC evaluate(FUNCTIONAL const & func, VEC const & x, VEC const & xm, VEC const & xr, USEFMA usefma);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字Iに対応する、K個の積分をまとめて行う関数へのポインタを返す
+            \return qgaussmultikernelの実体へのポインタ
+        */
+        template <typename FUNCTYPE, std::size_t K, std::size_t I>
+        static constexpr MultiKernel<FUNCTYPE, K> multientry(std::false_type);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字Iに対応する、K個の積分をまとめて行う関数へのポインタを返す（Summation::Reproducible）
+            Summation::Reproducibleでは、カーネルによらずSIMDを使わない実装で節の順に和を取る
+            \return qgaussmultiscalarの実体へのポインタ
+        */
+        template <typename FUNCTYPE, std::size_t K, std::size_t I>
+        static constexpr MultiKernel<FUNCTYPE, K> multientry(std::true_type);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字ごとに、K個の積分をまとめて行う関数へのポインタを並べた表を作る
+            \return K個の積分をまとめて行う関数へのポインタの表
+        */
+        template <typename FUNCTYPE, std::size_t K, std::size_t... I>
+        static constexpr std::array<MultiKernel<FUNCTYPE, K>, sizeof...(I)> multitable(std::index_sequence<I...>);
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使ってGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx") double qgaussavx(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX2命令とFMAを使ってGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx2,fma") double qgaussavx2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX-512F命令とFMAを使ってGauss-Legendre積分を実行する
+            端数の分点はマスク付きの命令で処理する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") double qgaussavx512(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使って、まとめてGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx") void qgaussbatchavx(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX2命令とFMAを使って、まとめてGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx2,fma") void qgaussbatchavx2(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX-512F命令とFMAを使って、まとめてGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") void qgaussbatchavx512(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            まとめてGauss-Legendre積分を実行する（qgaussの配列版の実装）
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <typename FUNCTIONAL>
+        void qgaussbatchimpl(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            KERNELに従って、まとめて積分を行う積分カーネルを呼び出す
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+        void qgaussbatchkernel(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleで、まとめてGauss-Legendre積分を実行する
+            区間ごとに、一つの区間の積分と同じ順序で和を取る
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+        void qgaussbatchrepro(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずに、まとめてGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        void qgaussbatchscalar(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使って、まとめてGauss-Legendre積分を実行する（各積分カーネルの共通部分）
+            格納している節がBATCHLANESMAX個以下のときは、ベクトルの各要素に別々の積分区間を割り当てて、
+            節のテーブルを区間W個につき一度だけ読む
+            それより多いときは、区間ごとにqgausssimdを呼び出す
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE void qgaussbatchsimd(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使って、まとめてGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端の配列
+            \param x2 積分の上端の配列
+            \param result 積分値を格納する配列
+            \param count 積分区間の数
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("sse2") void qgaussbatchsse2(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずに、被積分関数の配列をまとめて評価する形を使ってGauss-Legendre積分を実行する
+            節をBLOCKSIZE個ずつ積分区間に写して被積分関数に渡し、返ってきた関数値と重みの積を足し込む
+            累積変数への割り当てはqgaussscalarと同じである
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        double qgaussblockscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使って、被積分関数の配列をまとめて評価する形でGauss-Legendre積分を実行する
+            節の写像と重みとの積の和はSIMDで行い、被積分関数はBLOCKSIZE個の節につき一度だけ呼び出す
+            累積変数への割り当てはqgausssimdと同じである
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussblocksimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            複合則でGauss-Legendre積分を実行する（qgaussの複合則版の実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param panels パネルの数
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        double qgausscompositeimpl(FUNCTIONAL const & func, double x1, double x2, std::uint32_t panels) const;
+
+        //! A private member function (template function).
+        /*!
+            節を一次変換xm + xr * xで写して、重み付きの和を求める
+            \param func 被積分関数
+            \param xm 一次変換の平行移動（積分区間の中点）
+            \param xr 一次変換の拡大率（積分区間の幅の半分）
+            \return 重み付きの和（xrは掛けていない）
+        */
+        template <typename FUNCTIONAL>
+        double qgaussaffine(FUNCTIONAL const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            Gauss-Legendre積分を実行する（qgaussの実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        double qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const;
+
+        //! A private member function (template function).
+        /*!
+            KERNELに従って積分カーネルを呼び出す
+            被積分関数が配列をまとめて評価する形を持つときは、その形を使う積分カーネルを呼び出す
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+        double qgausskernel(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使って、K個の積分をまとめて実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        SIMD_TARGET("avx") std::array<double, K> qgaussmultiavx(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX2命令とFMAを使って、K個の積分をまとめて実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        SIMD_TARGET("avx2,fma") std::array<double, K> qgaussmultiavx2(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX-512F命令とFMAを使って、K個の積分をまとめて実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        SIMD_TARGET("avx512f") std::array<double, K> qgaussmultiavx512(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            K個の積分をまとめて実行する（qgaussのK個の値を返す被積分関数版の実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return K個の積分値
+        */
+        template <typename FUNCTYPE, std::size_t K>
+        std::array<double, K> qgaussmultiimpl(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double x1, double x2) const;
+
+        //! A private member function (template function).
+        /*!
+            KERNELに従って、K個の積分をまとめて行う積分カーネルを呼び出す
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTYPE, std::size_t K>
+        std::array<double, K> qgaussmultikernel(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずに、K個の積分をまとめて実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        std::array<double, K> qgaussmultiscalar(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使って、K個の積分をまとめて実行する（各積分カーネルの共通部分）
+            K個の累積変数がそれぞれ独立しているので、累積変数は一つの値につき一つだけ持つ
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        SIMD_FORCEINLINE std::array<double, K> qgaussmultisimd(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使って、K個の積分をまとめて実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return K個の重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+        SIMD_TARGET("sse2") std::array<double, K> qgaussmultisse2(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの重み付きの和を、AVX命令を使って求める（Kernel::AVXとKernel::AVX2で共通、FMAは使わない）
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭（NodeTable::LANESの倍数）
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（常に0）
+            \return 重み付きの和
+        */
+        template <bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx") SIMD_PRECISE double qgaussreproavx(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの重み付きの和を、AVX-512F命令を使って求める（FMAは使わない）
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭（NodeTable::LANESの倍数）
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（常に0）
+            \return 重み付きの和
+        */
+        template <bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") SIMD_PRECISE double qgaussreproavx512(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの重み付きの和を、SIMDを使わずに求める
+            節i（beginからの番号）はi % REPROLANES番目の累積変数に節の順に足し込み、FMAは使わない
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭（NodeTable::LANESの倍数）
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（常に0）
+            \return 重み付きの和
+        */
+        template <bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_PRECISE double qgaussreproscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの重み付きの和を、SIMDベクトルの型VECを使って求める
+            REPROLANES / W個のベクトルの累積変数を並べて、qgaussreproscalarと同じ順序で足し込む
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭（NodeTable::LANESの倍数）
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（常に0）
+            \return 重み付きの和
+        */
+        template <typename VEC, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussreprosimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの重み付きの和を、SSE2命令を使って求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭（NodeTable::LANESの倍数）
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（常に0）
+            \return 重み付きの和
+        */
+        template <bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("sse2") SIMD_PRECISE double qgaussreprosse2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずにGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        double qgaussscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使ってGauss-Legendre積分を実行する（各積分カーネルの共通部分）
+            ACCUMULATORS個の独立した累積変数に足し込み、水平加算は最後に一度だけ行う
+            端数の分点は、最後の分点で埋めたベクトルで処理する（埋めた要素の重みは0）
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgausssimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        //! A private member function (template function).
+        /*!
+            execution_に従って、全ての節についての重み付きの和を求める
+            Execution::Parallelのときは、節をPARALLELCHUNK個ずつのチャンクに分けて並列に和を取り、
+            チャンクの部分和をチャンクの順に足し合わせる（チャンクの分け方はスレッド数によらない）
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+        double qgausssum(FUNCTIONAL const & func, double xm, double xr) const;
+
+        //! A private member function.
+        /*!
+            部分和の配列を先頭から順に足し合わせる（summation_がSummation::Naiveでなければ補正付きで足す）
+            \param partial 部分和の配列
+            \param count 部分和の数
+            \return 部分和の合計
+        */
+        double reduce(double const * partial, std::size_t count) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使ってGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param begin 和を取る節の範囲の先頭
+            \param end 和を取る節の範囲の末尾の次
+            \param tail 重み付きの和の丸め誤差の見積もり（SUMMATIONがSummation::Naiveのときは0）
+            \return 重み付きの和
+        */
+        template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+        SIMD_TARGET("sse2") double qgausssse2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            まとめて積分するとき、SIMDベクトルの各要素に別々の積分区間を割り当てる分点の上限
+        */
+        static std::uint32_t constexpr BATCHLANESMAX = 64;
+
+        //! A private static member variable (constant).
+        /*!
+            被積分関数の配列をまとめて評価する形に、一度に渡す節の数
+        */
+        static std::uint32_t constexpr BLOCKSIZE = 256;
+
+        //! A private static member variable (constant).
+        /*!
+            複合則で、まとめて積分するパネルの数
+        */
+        static std::uint32_t constexpr COMPOSITEBLOCK = 256;
+
+        //! A private static member variable (constant).
+        /*!
+            積分カーネルの表の大きさ（重み付きの和を求める方法の数 × 格納方法の数 × 積分カーネルの数）
+        */
+        static std::uint32_t constexpr DISPATCHES = 4 * 2 * KERNELS;
+
+        //! A private static member variable (constant).
+        /*!
+            Execution::Parallelのときに、一つのチャンクに含める節の数
+            （NodeTable::LANESとACCUMULATORSの積の倍数にして、チャンクの先頭のalignmentを揃える）
+        */
+        static std::uint32_t constexpr PARALLELCHUNK = 2048;
+
+        //! A private member variable.
+        /*!
+            積分カーネルの表の添字（コンストラクタで、積分カーネルと和の取り方と格納方法から一度だけ求める）
+        */
+        std::uint32_t dispatch_;
+
+        //! A private member variable.
+        /*!
+            一回の積分の実行方法
+        */
+        Execution execution_;
+
+        //! A private member variable.
+        /*!
+            使用する積分カーネル
+        */
+        Kernel kernel_;
+
+        //! A private member variable.
+        /*!
+            重み付きの和を求める方法
+        */
+        Summation summation_;
+
+        //! A private member variable.
+        /*!
+            Gauss-Legendreの分点
+        */
+        std::uint32_t n_;
+
+        //! A private member variable.
+        /*!
+            節と重みの格納方法
+        */
+        Storage storage_;
+
+        //! A private member variable.
+        /*!
+            Gauss-Legendreの節と重み（プロセス全体で共有される）
+        */
+        std::shared_ptr<NodeTable const> table_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Gauss_Legendre() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+	};
+
+    template <typename FUNCTYPE>
+    inline double Gauss_Legendre::qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTYPE>
+    inline double Gauss_Legendre::qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTYPE>
+    inline void Gauss_Legendre::qgauss(myfunctional::Functional<FUNCTYPE> const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchimpl(func, x1, x2, result, count);
+    }
+
+    template <typename FUNCTYPE>
+    inline void Gauss_Legendre::qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchimpl(func, x1, x2, result, count);
+    }
+
+    template <typename FUNCTYPE>
+    inline double Gauss_Legendre::qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2, std::uint32_t panels) const
+    {
+        return qgausscompositeimpl(func, x1, x2, panels);
+    }
+
+    template <typename FUNCTYPE>
+    inline double Gauss_Legendre::qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2, std::uint32_t panels) const
+    {
+        return qgausscompositeimpl(func, x1, x2, panels);
+    }
+
+    template <typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgauss(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double x1, double x2) const
+    {
+        return qgaussmultiimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTIONAL, std::size_t... I>
+    inline constexpr std::array<Gauss_Legendre::AffineKernel<FUNCTIONAL>, sizeof...(I)> Gauss_Legendre::affinetable(std::index_sequence<I...>)
+    {
+        return { { &Gauss_Legendre::qgausssum<dispatchsummation(I), dispatchsymmetric(I), dispatchKernel(I), FUNCTIONAL>... } };
+    }
+
+    template <typename FUNCTIONAL, std::size_t I>
+    inline constexpr Gauss_Legendre::BatchKernel<FUNCTIONAL> Gauss_Legendre::batchentry(std::false_type)
+    {
+        return &Gauss_Legendre::qgaussbatchkernel<dispatchsummation(I), dispatchsymmetric(I), dispatchKernel(I), FUNCTIONAL>;
+    }
+
+    template <typename FUNCTIONAL, std::size_t I>
+    inline constexpr Gauss_Legendre::BatchKernel<FUNCTIONAL> Gauss_Legendre::batchentry(std::true_type)
+    {
+        return &Gauss_Legendre::qgaussbatchrepro<dispatchsymmetric(I), dispatchKernel(I), FUNCTIONAL>;
+    }
+
+    template <typename FUNCTIONAL, std::size_t... I>
+    inline constexpr std::array<Gauss_Legendre::BatchKernel<FUNCTIONAL>, sizeof...(I)> Gauss_Legendre::batchtable(std::index_sequence<I...>)
+    {
+        return { { batchentry<FUNCTIONAL, I>(std::integral_constant<bool, dispatchsummation(I) == Summation::Reproducible>())... } };
+    }
+
+    template <bool SYMMETRIC, typename FUNCTIONAL, typename VEC, typename USEFMA>
+    inline VEC Gauss_Legendre::evaluate(FUNCTIONAL const & func, VEC const & x, VEC const & xm, VEC const & xr, USEFMA usefma)
+    {
+        if (SYMMETRIC) {
+            VEC const d(x * xr);
+            return VEC(func(xm + d)) + VEC(func(xm - d));
+        }
+
+        return func(simd::muladd(x, xr, xm, usefma));
+    }
+
+    template <typename FUNCTYPE, std::size_t K, std::size_t I>
+    inline constexpr Gauss_Legendre::MultiKernel<FUNCTYPE, K> Gauss_Legendre::multientry(std::false_type)
+    {
+        return &Gauss_Legendre::qgaussmultikernel<dispatchsummation(I), dispatchsymmetric(I), dispatchKernel(I), FUNCTYPE, K>;
+    }
+
+    template <typename FUNCTYPE, std::size_t K, std::size_t I>
+    inline constexpr Gauss_Legendre::MultiKernel<FUNCTYPE, K> Gauss_Legendre::multientry(std::true_type)
+    {
+        return &Gauss_Legendre::qgaussmultiscalar<Summation::Reproducible, dispatchsymmetric(I), FUNCTYPE, K>;
+    }
+
+    template <typename FUNCTYPE, std::size_t K, std::size_t... I>
+    inline constexpr std::array<Gauss_Legendre::MultiKernel<FUNCTYPE, K>, sizeof...(I)> Gauss_Legendre::multitable(std::index_sequence<I...>)
+    {
+        return { { multientry<FUNCTYPE, K, I>(std::integral_constant<bool, dispatchsummation(I) == Summation::Reproducible>())... } };
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussavx(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return FUNCTIONAL::BATCH ?
+            qgaussblocksimd<simd::F64vec4, false, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail) :
+            qgausssimd<simd::F64vec4, false, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussavx2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return FUNCTIONAL::BATCH ?
+            qgaussblocksimd<simd::F64vec4, true, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail) :
+            qgausssimd<simd::F64vec4, true, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussavx512(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return FUNCTIONAL::BATCH ?
+            qgaussblocksimd<simd::F64vec8, true, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail) :
+            qgausssimd<simd::F64vec8, true, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchavx(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchsimd<simd::F64vec4, false, SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchavx2(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchsimd<simd::F64vec4, true, SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchavx512(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchsimd<simd::F64vec8, true, SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+    }
+
+    template <typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchimpl(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        static constexpr auto table = batchtable<FUNCTIONAL>(std::make_index_sequence<DISPATCHES>());
+        (this->*table[dispatch_])(func, x1, x2, result, count);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchkernel(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        switch (KERNEL) {
+        case Kernel::AVX512:
+            qgaussbatchavx512<SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+            break;
+
+        case Kernel::AVX2:
+            qgaussbatchavx2<SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+            break;
+
+        case Kernel::AVX:
+            qgaussbatchavx<SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+            break;
+
+        case Kernel::SSE2:
+            qgaussbatchsse2<SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+            break;
+
+        default:
+            qgaussbatchscalar<SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+            break;
+        }
+    }
+
+    template <bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchrepro(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            auto const xm = 0.5 * (x1[i] + x2[i]);
+            auto const xr = 0.5 * (x2[i] - x1[i]);
+            result[i] = qgausssum<Summation::Reproducible, SYMMETRIC, KERNEL>(func, xm, xr) * xr;
+        }
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchscalar(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            auto const xm = 0.5 * (x1[i] + x2[i]);
+            auto const xr = 0.5 * (x2[i] - x1[i]);
+            auto tail = 0.0;
+            auto const sum = qgaussscalar<SUMMATION, SYMMETRIC>(func, xm, xr, 0, table_->size(), tail);
+            result[i] = (sum + tail) * xr;
+        }
+    }
+
+    template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchsimd(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const x = table_->x();
+        auto const w = table_->w();
+        auto const nstored = table_->size();
+
+        if (nstored > BATCHLANESMAX) {
+            // 分点が多いときは、区間ごとに節の方向でベクトル化する
+            for (std::size_t i = 0; i < count; i++) {
+                auto const xm = 0.5 * (x1[i] + x2[i]);
+                auto const xr = 0.5 * (x2[i] - x1[i]);
+                auto tail = 0.0;
+                auto const sum = qgausssimd<VEC, FMA, SUMMATION, SYMMETRIC>(func, xm, xr, 0, nstored, tail);
+                result[i] = (sum + tail) * xr;
+            }
+
+            return;
+        }
+
+        VEC const half(0.5);
+        for (std::size_t i = 0; i < count; i += W) {
+            // 端数の区間は、先頭の区間で埋めたベクトルで処理する
+            auto const m = count - i < W ? static_cast<std::uint32_t>(count - i) : W;
+            VEC const a(m == W ? VEC::loadu(x1 + i) : VEC::loadpartial(x1 + i, m, x1[i]));
+            VEC const b(m == W ? VEC::loadu(x2 + i) : VEC::loadpartial(x2 + i, m, x2[i]));
+            VEC const xm(half * (a + b));
+            VEC const xr(half * (b - a));
+
+            VEC sum(0.0), comp(0.0);
+            for (auto j = 0U; j < nstored; j++) {
+                auto const f(evaluate<SYMMETRIC>(func, VEC(x[j]), xm, xr, usefma));
+                accumulate<SUMMATION>(VEC(w[j]), f, sum, comp, usefma);
+            }
+
+            VEC const r((SUMMATION != Summation::Naive ? VEC(sum + comp) : sum) * xr);
+            if (m == W) {
+                r.storeu(result + i);
+            }
+            else {
+                r.storepartial(result + i, m);
+            }
+        }
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline void Gauss_Legendre::qgaussbatchsse2(FUNCTIONAL const & func, double const * x1, double const * x2, double * result, std::size_t count) const
+    {
+        qgaussbatchsimd<simd::F64vec2, false, SUMMATION, SYMMETRIC>(func, x1, x2, result, count);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussblockscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        auto const x = table_->x();
+        auto const w = table_->w();
+        std::array<double, BLOCKSIZE> xp, fp, xn, fn;
+        std::array<double, ACCUMULATORS> sum = {}, comp = {};
+
+        for (auto i = begin; i < end; i += BLOCKSIZE) {
+            std::size_t const count = std::min(BLOCKSIZE, end - i);
+            auto const xb = x + i;
+            auto const wb = w + i;
+
+            // 節の写像はevaluateと同じ式で行う
+            for (std::size_t j = 0; j < count; j++) {
+                if (SYMMETRIC) {
+                    auto const d = xb[j] * xr;
+                    xp[j] = xm + d;
+                    xn[j] = xm - d;
+                }
+                else {
+                    xp[j] = xb[j] * xr + xm;
+                }
+            }
+
+            func(xp.data(), fp.data(), count);
+            if (SYMMETRIC) {
+                func(xn.data(), fn.data(), count);
+            }
+
+            // BLOCKSIZEはACCUMULATORSの倍数なので、節i + jはsum[j % ACCUMULATORS]に足し込まれる
+            std::size_t j = 0;
+            for (; j + ACCUMULATORS <= count; j += ACCUMULATORS) {
+                for (auto k = 0U; k < ACCUMULATORS; k++) {
+                    accumulate<SUMMATION>(wb[j + k], SYMMETRIC ? fp[j + k] + fn[j + k] : fp[j + k], sum[k], comp[k], std::false_type());
+                }
+            }
+
+            for (auto k = 0U; j < count; j++, k++) {
+                accumulate<SUMMATION>(wb[j], SYMMETRIC ? fp[j] + fn[j] : fp[j], sum[k], comp[k], std::false_type());
+            }
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                auto e = 0.0;
+                hi = simd::twosum(hi, sum[k], e);
+                lo += e + comp[k];
+            }
+
+            tail = lo;
+            return hi;
+        }
+
+        tail = 0.0;
+        return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+    template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussblocksimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const x = table_->x();
+        auto const w = table_->w();
+        VEC const xmv(xm);
+        VEC const xrv(xr);
+        std::array<double, BLOCKSIZE> xp, fp, xn, fn;
+        std::array<VEC, ACCUMULATORS> sum, comp;
+        sum.fill(VEC(0.0));
+        comp.fill(VEC(0.0));
+
+        for (auto i = begin; i < end; i += BLOCKSIZE) {
+            auto const count = std::min(BLOCKSIZE, end - i);
+            auto const xb = x + i;
+            auto const wb = w + i;
+
+            // 端数の節もテーブルの埋め草（最後の節と重み0）を読んでベクトル単位で写す
+            for (auto j = 0U; j < count; j += W) {
+                auto const xv(VEC::load(xb + j));
+                if (SYMMETRIC) {
+                    VEC const d(xv * xrv);
+                    VEC(xmv + d).storeu(xp.data() + j);
+                    VEC(xmv - d).storeu(xn.data() + j);
+                }
+                else {
+                    simd::muladd(xv, xrv, xmv, usefma).storeu(xp.data() + j);
+                }
+            }
+
+            // 被積分関数に渡すのはcount個だけなので、端数のベクトルの残りの要素は0にしておく
+            func(xp.data(), fp.data(), count);
+            std::fill(fp.data() + count, fp.data() + (count + W - 1) / W * W, 0.0);
+            if (SYMMETRIC) {
+                func(xn.data(), fn.data(), count);
+                std::fill(fn.data() + count, fn.data() + (count + W - 1) / W * W, 0.0);
+            }
+
+            auto j = 0U;
+            for (; j + W * ACCUMULATORS <= count; j += W * ACCUMULATORS) {
+                for (auto k = 0U; k < ACCUMULATORS; k++) {
+                    auto const o = j + k * W;
+                    VEC const f(SYMMETRIC ? VEC(VEC::loadu(fp.data() + o) + VEC::loadu(fn.data() + o)) : VEC::loadu(fp.data() + o));
+                    accumulate<SUMMATION>(VEC::load(wb + o), f, sum[k], comp[k], usefma);
+                }
+            }
+
+            for (; j + W <= count; j += W) {
+                VEC const f(SYMMETRIC ? VEC(VEC::loadu(fp.data() + j) + VEC::loadu(fn.data() + j)) : VEC::loadu(fp.data() + j));
+                accumulate<SUMMATION>(VEC::load(wb + j), f, sum[0], comp[0], usefma);
+            }
+
+            if (j < count) {
+                VEC const f(SYMMETRIC ? VEC(VEC::loadu(fp.data() + j) + VEC::loadu(fn.data() + j)) : VEC::loadu(fp.data() + j));
+                accumulate<SUMMATION>(VEC::load(wb + j), f, sum[1], comp[1], usefma);
+            }
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                for (auto j = 0U; j < W; j++) {
+                    auto e = 0.0;
+                    hi = simd::twosum(hi, sum[k][j], e);
+                    lo += e + comp[k][j];
+                }
+            }
+
+            tail = lo;
+            return hi;
+        }
+
+        tail = 0.0;
+        return simd::add_horizontal((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgausscompositeimpl(FUNCTIONAL const & func, double x1, double x2, std::uint32_t panels) const
+    {
+        if (!panels) {
+            return 0.0;
+        }
+
+        auto const h = (x2 - x1) / static_cast<double>(panels);
+        auto const blocks = static_cast<std::int32_t>((panels + COMPOSITEBLOCK - 1) / COMPOSITEBLOCK);
+        std::vector<double> partial(blocks);
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) if (execution_ == Execution::Parallel && blocks > 1)
+#endif
+        for (auto c = 0; c < blocks; c++) {
+            std::array<double, COMPOSITEBLOCK> a, b, r;
+
+            auto const first = static_cast<std::uint32_t>(c) * COMPOSITEBLOCK;
+            auto const count = std::min(COMPOSITEBLOCK, panels - first);
+            for (auto i = 0U; i < count; i++) {
+                // パネルの端は下端からの倍数で求め、誤差が蓄積しないようにする
+                a[i] = x1 + h * static_cast<double>(first + i);
+                b[i] = first + i + 1 == panels ? x2 : x1 + h * static_cast<double>(first + i + 1);
+            }
+
+            qgaussbatchimpl(func, a.data(), b.data(), r.data(), count);
+            partial[c] = reduce(r.data(), count);
+        }
+
+        // まとまりごとの和はスレッド数によらずまとまりの順に足し合わせる
+        return reduce(partial.data(), partial.size());
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussaffine(FUNCTIONAL const & func, double xm, double xr) const
+    {
+        // 積分カーネルと和の取り方と格納方法の組はコンストラクタで決めてあるので、表を一度引くだけでよい
+        static constexpr auto table = affinetable<FUNCTIONAL>(std::make_index_sequence<DISPATCHES>());
+        return (this->*table[dispatch_])(func, xm, xr);
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const
+    {
+        auto const xm = 0.5 * (x1 + x2);
+        auto const xr = 0.5 * (x2 - x1);
+
+        return qgaussaffine(func, xm, xr) * xr;
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgausskernel(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        // Summation::Reproducibleでは、積和を融合させない専用の関数を使う
+        if (SUMMATION == Summation::Reproducible) {
+            switch (KERNEL) {
+            case Kernel::AVX512:
+                return qgaussreproavx512<SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+            case Kernel::AVX2:
+            case Kernel::AVX:
+                return qgaussreproavx<SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+            case Kernel::SSE2:
+                return qgaussreprosse2<SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+            default:
+                return qgaussreproscalar<SYMMETRIC>(func, xm, xr, begin, end, tail);
+            }
+        }
+
+        switch (KERNEL) {
+        case Kernel::AVX512:
+            return qgaussavx512<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+        case Kernel::AVX2:
+            return qgaussavx2<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+        case Kernel::AVX:
+            return qgaussavx<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+        case Kernel::SSE2:
+            return qgausssse2<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+
+        default:
+            return FUNCTIONAL::BATCH ?
+                qgaussblockscalar<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail) :
+                qgaussscalar<SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
+        }
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultiavx(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        return qgaussmultisimd<simd::F64vec4, false, SUMMATION, SYMMETRIC>(func, xm, xr);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultiavx2(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        return qgaussmultisimd<simd::F64vec4, true, SUMMATION, SYMMETRIC>(func, xm, xr);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultiavx512(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        return qgaussmultisimd<simd::F64vec8, true, SUMMATION, SYMMETRIC>(func, xm, xr);
+    }
+
+    template <typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultiimpl(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double x1, double x2) const
+    {
+        auto const xm = 0.5 * (x1 + x2);
+        auto const xr = 0.5 * (x2 - x1);
+
+        static constexpr auto table = multitable<FUNCTYPE, K>(std::make_index_sequence<DISPATCHES>());
+        auto sum = (this->*table[dispatch_])(func, xm, xr);
+
+        for (auto & s : sum) {
+            s *= xr;
+        }
+
+        return sum;
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultikernel(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        switch (KERNEL) {
+        case Kernel::AVX512:
+            return qgaussmultiavx512<SUMMATION, SYMMETRIC>(func, xm, xr);
+
+        case Kernel::AVX2:
+            return qgaussmultiavx2<SUMMATION, SYMMETRIC>(func, xm, xr);
+
+        case Kernel::AVX:
+            return qgaussmultiavx<SUMMATION, SYMMETRIC>(func, xm, xr);
+
+        case Kernel::SSE2:
+            return qgaussmultisse2<SUMMATION, SYMMETRIC>(func, xm, xr);
+
+        default:
+            return qgaussmultiscalar<SUMMATION, SYMMETRIC>(func, xm, xr);
+        }
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultiscalar(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        auto const x = table_->x();
+        auto const w = table_->w();
+        auto const nstored = table_->size();
+        std::array<double, K> sum = {}, comp = {};
+
+        for (auto i = 0U; i < nstored; i++) {
+            auto const d = x[i] * xr;
+            auto f = func(xm + d);
+            if (SYMMETRIC) {
+                auto const g = func(xm - d);
+                for (std::size_t k = 0; k < K; k++) {
+                    f[k] += g[k];
+                }
+            }
+
+            for (std::size_t k = 0; k < K; k++) {
+                accumulate<SUMMATION>(w[i], f[k], sum[k], comp[k], std::false_type());
+            }
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            for (std::size_t k = 0; k < K; k++) {
+                sum[k] += comp[k];
+            }
+        }
+
+        return sum;
+    }
+
+    template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultisimd(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const x = table_->x();
+        auto const w = table_->w();
+        auto const nstored = table_->size();
+        VEC const xmv(xm);
+        VEC const xrv(xr);
+        std::array<VEC, K> sum, comp;
+        sum.fill(VEC(0.0));
+        comp.fill(VEC(0.0));
+
+        // 端数の分点は、テーブルの埋め草（最後の節と重み0）をそのまま読む
+        for (auto i = 0U; i < nstored; i += W) {
+            VEC const xv(VEC::load(&x[i]));
+            VEC const wv(VEC::load(&w[i]));
+            if (SYMMETRIC) {
+                VEC const d(xv * xrv);
+                auto const f(func(VEC(xmv + d)));
+                auto const g(func(VEC(xmv - d)));
+                for (std::size_t k = 0; k < K; k++) {
+                    accumulate<SUMMATION>(wv, VEC(f[k] + g[k]), sum[k], comp[k], usefma);
+                }
+            }
+            else {
+                auto const f(func(simd::muladd(xv, xrv, xmv, usefma)));
+                for (std::size_t k = 0; k < K; k++) {
+                    accumulate<SUMMATION>(wv, f[k], sum[k], comp[k], usefma);
+                }
+            }
+        }
+
+        std::array<double, K> result;
+        for (std::size_t k = 0; k < K; k++) {
+            result[k] = simd::add_horizontal(SUMMATION != Summation::Naive ? VEC(sum[k] + comp[k]) : sum[k]);
+        }
+
+        return result;
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTYPE, std::size_t K>
+    inline std::array<double, K> Gauss_Legendre::qgaussmultisse2(myfunctional::MultiFunctional<FUNCTYPE, K> const & func, double xm, double xr) const
+    {
+        return qgaussmultisimd<simd::F64vec2, false, SUMMATION, SYMMETRIC>(func, xm, xr);
+    }
+
+    template <bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussreproavx(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return qgaussreprosimd<simd::F64vec4, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussreproavx512(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return qgaussreprosimd<simd::F64vec8, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussreproscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        auto const x = table_->x();
+
+        // 端数の節は、SIMDベクトルの幅によらずNodeTable::LANESの倍数まで埋め草（重み0）を読む
+        auto const last = (end + NodeTable::LANES - 1) / NodeTable::LANES * NodeTable::LANES;
+        tail = 0.0;
+        return reproducibleSum(table_->w(), begin, last, [&](std::uint32_t i) {
+            return evaluate<SYMMETRIC>(func, x[i], xm, xr, std::false_type());
+        });
+    }
+
+    template <typename VEC, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussreprosimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        auto const x = table_->x();
+        VEC const vxm(xm), vxr(xr);
+
+        auto const last = (end + NodeTable::LANES - 1) / NodeTable::LANES * NodeTable::LANES;
+        tail = 0.0;
+        return reproducibleSumSimd<VEC>(table_->w(), begin, last, [&](std::uint32_t j) {
+            return evaluate<SYMMETRIC>(func, VEC::load(&x[j]), vxm, vxr, std::false_type());
+        });
+    }
+
+    template <bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussreprosse2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return qgaussreprosimd<simd::F64vec2, SYMMETRIC>(func, xm, xr, begin, end, tail);
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgaussscalar(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        auto const x = table_->x();
+        auto const w = table_->w();
+        std::array<double, ACCUMULATORS> sum = {}, comp = {};
+
+        auto i = begin;
+        for (; i + ACCUMULATORS <= end; i += ACCUMULATORS) {
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                accumulate<SUMMATION>(w[i + k], evaluate<SYMMETRIC>(func, x[i + k], xm, xr, std::false_type()), sum[k], comp[k], std::false_type());
+            }
+        }
+
+        for (auto k = 0U; i < end; i++, k++) {
+            accumulate<SUMMATION>(w[i], evaluate<SYMMETRIC>(func, x[i], xm, xr, std::false_type()), sum[k], comp[k], std::false_type());
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                auto e = 0.0;
+                hi = simd::twosum(hi, sum[k], e);
+                lo += e + comp[k];
+            }
+
+            tail = lo;
+            return hi;
+        }
+
+        tail = 0.0;
+        return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+    template <typename VEC, bool FMA, Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgausssimd(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const x = table_->x();
+        auto const w = table_->w();
+        VEC const xmv(xm);
+        VEC const xrv(xr);
+        std::array<VEC, ACCUMULATORS> sum, comp;
+        sum.fill(VEC(0.0));
+        comp.fill(VEC(0.0));
+
+        auto i = begin;
+        for (; i + W * ACCUMULATORS <= end; i += W * ACCUMULATORS) {
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                auto const f(evaluate<SYMMETRIC>(func, VEC::load(&x[i + k * W]), xmv, xrv, usefma));
+                accumulate<SUMMATION>(VEC::load(&w[i + k * W]), f, sum[k], comp[k], usefma);
+            }
+        }
+
+        for (; i + W <= end; i += W) {
+            auto const f(evaluate<SYMMETRIC>(func, VEC::load(&x[i]), xmv, xrv, usefma));
+            accumulate<SUMMATION>(VEC::load(&w[i]), f, sum[0], comp[0], usefma);
+        }
+
+        if (i < end) {
+            auto const f(evaluate<SYMMETRIC>(func, VEC::loadpartial(&x[i], end - i, x[end - 1]), xmv, xrv, usefma));
+            accumulate<SUMMATION>(VEC::loadpartial(&w[i], end - i, 0.0), f, sum[1], comp[1], usefma);
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                for (auto j = 0U; j < W; j++) {
+                    auto e = 0.0;
+                    hi = simd::twosum(hi, sum[k][j], e);
+                    lo += e + comp[k][j];
+                }
+            }
+
+            tail = lo;
+            return hi;
+        }
+
+        tail = 0.0;
+        return simd::add_horizontal((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, Kernel KERNEL, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgausssum(FUNCTIONAL const & func, double xm, double xr) const
+    {
+        auto const nstored = table_->size();
+        if (nstored <= PARALLELCHUNK || (execution_ == Execution::Sequential && SUMMATION != Summation::Reproducible)) {
+            auto tail = 0.0;
+            auto const sum = qgausskernel<SUMMATION, SYMMETRIC, KERNEL>(func, xm, xr, 0, nstored, tail);
+            return sum + tail;
+        }
+
+        auto const chunks = static_cast<std::int32_t>((nstored + PARALLELCHUNK - 1) / PARALLELCHUNK);
+        std::vector<double> partial(chunks), tail(chunks);
+
+        auto const sumchunk = [&](std::int32_t c) {
+            auto const begin = static_cast<std::uint32_t>(c) * PARALLELCHUNK;
+            partial[c] = qgausskernel<SUMMATION, SYMMETRIC, KERNEL>(func, xm, xr, begin, std::min(begin + PARALLELCHUNK, nstored), tail[c]);
+        };
+
+        if (execution_ == Execution::Parallel) {
+#ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+#endif
+            for (auto c = 0; c < chunks; c++) {
+                sumchunk(c);
+            }
+        }
+        else {
+            // Summation::Reproducibleでは、Execution::Sequentialでも同じチャンクに分けて和を取る
+            for (auto c = 0; c < chunks; c++) {
+                sumchunk(c);
+            }
+        }
+
+        // 部分和はスレッド数によらずチャンクの順に足し合わせる
+        // 部分和の丸め誤差も別に足し合わせるので、補正付きの和の精度はチャンクに分けても落ちない
+        return SUMMATION == Summation::Naive ?
+            reduce(partial.data(), partial.size()) :
+            reduce(partial.data(), partial.size()) + reduce(tail.data(), tail.size());
+    }
+
+    template <Summation SUMMATION, bool SYMMETRIC, typename FUNCTIONAL>
+    inline double Gauss_Legendre::qgausssse2(FUNCTIONAL const & func, double xm, double xr, std::uint32_t begin, std::uint32_t end, double & tail) const
+    {
+        return FUNCTIONAL::BATCH ?
+            qgaussblocksimd<simd::F64vec2, false, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail) :
+            qgausssimd<simd::F64vec2, false, SUMMATION, SYMMETRIC>(func, xm, xr, begin, end, tail);
     }
 }
 
@@ -0,0 +1,530 @@
+﻿/*! \file Gauss_Legendre_Fixed.h
+    \brief 分点数をコンパイル時に固定したGauss-Legendre積分を行うクラスの宣言と実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _GAUSS_LEGENDRE_FIXED_H_
+#define _GAUSS_LEGENDRE_FIXED_H_
+
+#pragma once
+
+#include "Functional.h"
+#include "nodetable.h"
+#include "simdvec.h"    // for simd::F64vec8, simd::F64vec4, simd::F64vec2, simd::add_horizontal
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <limits>       // for std::numeric_limits
+#include <type_traits>  // for std::false_type, std::integral_constant, std::true_type
+
+namespace gausslegendre {
+    namespace fixed {
+        //! A typedef.
+        /*!
+            VectorFunctionalの被積分関数に渡すSIMDベクトルの型
+            実行時のディスパッチはしないので、このヘッダをインクルードした翻訳単位のコンパイラのオプションで有効な最も長いベクトルを使う
+        */
+#if defined(__AVX512F__)
+        using Vector = simd::F64vec8;
+#elif defined(__AVX__)
+        using Vector = simd::F64vec4;
+#else
+        using Vector = simd::F64vec2;
+#endif
+
+        //! A template struct.
+        /*!
+            Gauss-Legendreの節と重みを格納する構造体
+            配列の長さはNをNodeTable::LANESの倍数に切り上げたもので、埋め草の節は最後の節、重みは0である
+            \param N Gauss-Legendreの分点
+        */
+        template <std::uint32_t N>
+        struct alignas(NodeTable::ALIGNMENT) Table final {
+            //! A public static member variable (constant).
+            /*!
+                節の配列と重みの配列の長さ
+            */
+            static std::uint32_t constexpr STRIDE = NodeTable::strideOf(N);
+
+            //! A public member variable.
+            /*!
+                Gauss-Legendreの節（昇順）
+            */
+            double x[STRIDE];
+
+            //! A public member variable.
+            /*!
+                Gauss-Legendreの重み
+            */
+            double w[STRIDE];
+        };
+
+        //! A function.
+        /*!
+            0 <= theta <= πの範囲でcos(theta)を計算する（コンパイル時計算用）
+            \param theta 角度
+            \return cos(theta)
+        */
+        constexpr double cos(double theta)
+        {
+            // cos(theta) = -cos(theta - π)で引数を[-π/2, π/2]に縮めてからTaylor展開する
+            auto const pi = 3.14159265358979323846;
+            auto sign = 1.0;
+            if (theta > 0.5 * pi) {
+                theta -= pi;
+                sign = -1.0;
+            }
+
+            auto const theta2 = theta * theta;
+            auto term = 1.0;
+            auto sum = 1.0;
+            for (auto k = 1; k <= 15; k++) {
+                term *= -theta2 / static_cast<double>((2 * k - 1) * (2 * k));
+                sum += term;
+            }
+
+            return sign * sum;
+        }
+
+        //! A function.
+        /*!
+            n次のLegendre多項式の値と、その導関数の値を求める（コンパイル時計算用）
+            \param n Legendre多項式の次数
+            \param x xの値
+            \param dp P'_n(x)の値
+            \return P_n(x)の値
+        */
+        constexpr double legendre(std::uint32_t n, double x, double & dp)
+        {
+            auto p0 = 1.0;
+            auto p1 = x;
+            for (auto k = 2U; k <= n; k++) {
+                auto const p2 = (static_cast<double>(2 * k - 1) * x * p1 - static_cast<double>(k - 1) * p0) / static_cast<double>(k);
+                p0 = p1;
+                p1 = p2;
+            }
+
+            auto const p = n == 0 ? 1.0 : p1;
+            auto const pm1 = n == 0 ? 0.0 : p0;
+            dp = static_cast<double>(n) * (pm1 - x * p) / ((1.0 - x) * (1.0 + x));
+
+            return p;
+        }
+
+        //! A struct.
+        /*!
+            二つのdoubleの和で表した数（double-double、コンパイル時計算用）
+        */
+        struct DoubleDouble final {
+            //! A public member variable.
+            /*!
+                上位の部分
+            */
+            double hi;
+
+            //! A public member variable.
+            /*!
+                下位の部分（|lo| <= ulp(hi) / 2）
+            */
+            double lo;
+        };
+
+        //! A function.
+        /*!
+            a + bを丸め誤差なしで求める（TwoSum、コンパイル時計算用）
+            \param a 一つ目の数
+            \param b 二つ目の数
+            \return a + b
+        */
+        constexpr DoubleDouble twosum(double a, double b)
+        {
+            auto const s = a + b;
+            auto const bb = s - a;
+
+            return { s, (a - (s - bb)) + (b - bb) };
+        }
+
+        //! A function.
+        /*!
+            a * bを丸め誤差なしで求める（DekkerのTwoProduct、コンパイル時計算なのでFMAは使わない）
+            \param a 一つ目の数
+            \param b 二つ目の数
+            \return a * b
+        */
+        constexpr DoubleDouble twoprod(double a, double b)
+        {
+            auto const split = 134217729.0;     // 2^27 + 1
+            auto const ca = split * a;
+            auto const ah = ca - (ca - a);
+            auto const al = a - ah;
+            auto const cb = split * b;
+            auto const bh = cb - (cb - b);
+            auto const bl = b - bh;
+            auto const p = a * b;
+
+            return { p, ((ah * bh - p) + ah * bl + al * bh) + al * bl };
+        }
+
+        //! A function.
+        /*!
+            double-doubleの和を求める（コンパイル時計算用）
+            \param a 一つ目の数
+            \param b 二つ目の数
+            \return a + b
+        */
+        constexpr DoubleDouble add(DoubleDouble const & a, DoubleDouble const & b)
+        {
+            auto const s = twosum(a.hi, b.hi);
+            return twosum(s.hi, s.lo + a.lo + b.lo);
+        }
+
+        //! A function.
+        /*!
+            double-doubleとdoubleの積を求める（コンパイル時計算用）
+            \param a double-doubleの数
+            \param b doubleの数
+            \return a * b
+        */
+        constexpr DoubleDouble mul(DoubleDouble const & a, double b)
+        {
+            auto const p = twoprod(a.hi, b);
+            return twosum(p.hi, p.lo + a.lo * b);
+        }
+
+        //! A function.
+        /*!
+            double-doubleの積を求める（コンパイル時計算用）
+            \param a 一つ目の数
+            \param b 二つ目の数
+            \return a * b
+        */
+        constexpr DoubleDouble mul(DoubleDouble const & a, DoubleDouble const & b)
+        {
+            auto const p = twoprod(a.hi, b.hi);
+            return twosum(p.hi, p.lo + a.hi * b.lo + a.lo * b.hi);
+        }
+
+        //! A function.
+        /*!
+            double-doubleの商を求める（コンパイル時計算用）
+            \param a 割られる数
+            \param b 割る数
+            \return a / b
+        */
+        constexpr DoubleDouble div(DoubleDouble const & a, DoubleDouble const & b)
+        {
+            auto const q = a.hi / b.hi;
+            auto const r = add(a, mul(b, -q));
+            return twosum(q, r.hi / b.hi);
+        }
+
+        //! A function.
+        /*!
+            Gauss-Legendreの重みを、double-doubleで評価した漸化式から求める（コンパイル時計算用）
+            w(x) = 2 / ((1 - x^2) P'_n(x)^2) = 2 (1 - x^2) / (n (P_{n-1}(x) - x P_n(x)))^2
+            1に近い根では、1 - x^2の桁落ちと漸化式の丸め誤差が重みの相対誤差として拡大されるので、doubleでは評価しない
+            また、dlog(w)/dx = -2x / (1 - x^2)なので、節xの丸め誤差（0.5ulp）も重みの相対誤差として1 / (1 - x^2)倍に拡大される
+            そこでNewton法の修正量P_n(x) / P'_n(x)（x - 真の根）を使って、真の根での重みに一次の補正をする
+            \param n Gauss-Legendreの分点（1以上）
+            \param x 節（doubleに丸めた根）
+            \return 真の根での重み
+        */
+        constexpr DoubleDouble weight(std::uint32_t n, double x)
+        {
+            DoubleDouble p0 = { 1.0, 0.0 };
+            DoubleDouble p1 = { x, 0.0 };
+            for (auto k = 2U; k <= n; k++) {
+                auto const t = add(mul(mul(p1, x), static_cast<double>(2 * k - 1)), mul(p0, -static_cast<double>(k - 1)));
+                p0 = p1;
+                p1 = div(t, { static_cast<double>(k), 0.0 });
+            }
+
+            // 1 - xとnは丸め誤差なしで求まる（Sterbenzの補題）
+            auto const oneminusx2 = mul(twosum(1.0, x), 1.0 - x);
+            auto const q = mul(add(p0, mul(p1, -x)), static_cast<double>(n));
+
+            auto const w = div(mul(oneminusx2, 2.0), mul(q, q));
+
+            // P_n(x) / P'_n(x) = (1 - x^2) P_n(x) / (n (P_{n-1}(x) - x P_n(x)))
+            return mul(w, 1.0 + 2.0 * x * (p1.hi / q.hi));
+        }
+
+        //! A template function.
+        /*!
+            N点のGauss-Legendreの節と重みを、Legendre多項式の根をNewton法で求めて計算する（コンパイル時計算用）
+            \param N Gauss-Legendreの分点
+            \return 節と重み
+        */
+        template <std::uint32_t N>
+        constexpr Table<N> makeTable()
+        {
+            Table<N> table = {};
+            auto const pi = 3.14159265358979323846;
+            auto const n = static_cast<double>(N);
+
+            // 根はx = 0について対称なので、正の根（と奇数次の場合の0）だけを求める
+            for (auto i = 0U; i < (N + 1) / 2; i++) {
+                // Tricomiの漸近式による初期値
+                auto const theta = pi * (static_cast<double>(i) + 0.75) / (n + 0.5);
+                auto x = (1.0 - (n - 1.0) / (8.0 * n * n * n)) * cos(theta);
+
+                // 修正量がxの1ulp程度以下になるか、xが変化しなくなったら収束とみなす
+                // （絶対誤差で判定すると、1に近い根では修正量が1ulpより小さくならずに反復が上限まで続く）
+                auto const eps = std::numeric_limits<double>::epsilon();
+                auto dp = 0.0;
+                for (auto iter = 0; iter < 100; iter++) {
+                    auto const p = legendre(N, x, dp);
+                    auto const dx = p / dp;
+                    auto const xold = x;
+                    x -= dx;
+                    if (x == xold || (dx < 0.0 ? -dx : dx) <= eps * (x < 0.0 ? -x : x)) {
+                        break;
+                    }
+                }
+
+                auto const w = weight(N, x).hi;
+
+                table.x[N - 1 - i] = x;
+                table.w[N - 1 - i] = w;
+                table.x[i] = -x;
+                table.w[i] = w;
+            }
+
+            if (N % 2) {
+                table.x[N / 2] = 0.0;
+            }
+
+            for (auto i = N; i < Table<N>::STRIDE; i++) {
+                table.x[i] = table.x[N - 1];
+            }
+
+            return table;
+        }
+
+        //! A template struct.
+        /*!
+            Gauss-Legendre積分の和を、コンパイル時に完全に展開して二分木の順に計算する
+            \param N Gauss-Legendreの分点
+            \param BEGIN 和を取る範囲の先頭
+            \param COUNT 和を取る項の数
+        */
+        template <std::uint32_t N, std::uint32_t BEGIN, std::uint32_t COUNT>
+        struct Unroll final {
+            //! A public static member function (template function).
+            /*!
+                [BEGIN, BEGIN + COUNT)の範囲の重み付きの和を返す
+                \param table 節と重み
+                \param f 節の番号を受け取り、その節での関数値を返す関数
+                \return 重み付きの和
+            */
+            template <typename FUNC>
+            static SIMD_FORCEINLINE double sum(Table<N> const & table, FUNC const & f)
+            {
+                return Unroll<N, BEGIN, COUNT / 2>::sum(table, f) +
+                       Unroll<N, BEGIN + COUNT / 2, COUNT - COUNT / 2>::sum(table, f);
+            }
+        };
+
+        //! A template struct.
+        /*!
+            Gauss-Legendre積分の和の一項を計算する（Unrollの部分特殊化）
+            \param N Gauss-Legendreの分点
+            \param BEGIN 項の番号
+        */
+        template <std::uint32_t N, std::uint32_t BEGIN>
+        struct Unroll<N, BEGIN, 1> final {
+            //! A public static member function (template function).
+            /*!
+                BEGIN番目の項を返す
+                \param table 節と重み
+                \param f 節の番号を受け取り、その節での関数値を返す関数
+                \return 重み付きの項
+            */
+            template <typename FUNC>
+            static SIMD_FORCEINLINE double sum(Table<N> const & table, FUNC const & f)
+            {
+                return table.w[BEGIN] * f(BEGIN);
+            }
+        };
+    }
+
+    //! A template class.
+    /*!
+        分点数をコンパイル時に固定したGauss-Legendre積分を行うクラス
+        節と重みはコンパイル時に計算され、積分のループは完全に展開される
+        \param N Gauss-Legendreの分点（1以上64以下）
+    */
+    template <std::uint32_t N>
+    class Gauss_Legendre_Fixed final
+    {
+        static_assert(N >= 1 && N <= 64, "Gauss_Legendre_Fixed supports 1 <= N <= 64");
+
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ
+            節と重みはコンパイル時に計算済みなので、何もしない
+        */
+        constexpr Gauss_Legendre_Fixed() = default;
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            Gauss-Legendre積分を実行する
+            被積分関数が配列をまとめて評価する形を持つときは、N個の節を一度に渡す
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const
+        {
+            return qgaussimpl(func, x1, x2, std::integral_constant<bool, myfunctional::Functional<FUNCTYPE>::BATCH>());
+        }
+
+        //! A public member function (template function).
+        /*!
+            Gauss-Legendre積分を実行する
+            被積分関数は、写像した節をfixed::VectorのSIMDベクトルごとにまとめて評価する
+            被積分関数が配列をまとめて評価する形を持つときは、N個の節を一度に渡す
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const
+        {
+            return qgaussvector(func, x1, x2, std::integral_constant<bool, myfunctional::VectorFunctional<FUNCTYPE>::BATCH>());
+        }
+
+        //! A public static member function.
+        /*!
+            i番目の節を返す
+            \param i 節の番号
+            \return i番目の節
+        */
+        static constexpr double x(std::uint32_t i)
+        {
+            return table.x[i];
+        }
+
+        //! A public static member function.
+        /*!
+            i番目の重みを返す
+            \param i 重みの番号
+            \return i番目の重み
+        */
+        static constexpr double w(std::uint32_t i)
+        {
+            return table.w[i];
+        }
+
+    private:
+        //! A private member function (template function).
+        /*!
+            被積分関数を節ごとに呼び出して、Gauss-Legendre積分を実行する（qgaussの実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussimpl(FUNCTIONAL const & func, double x1, double x2, std::false_type) const
+        {
+            auto const xm = 0.5 * (x1 + x2);
+            auto const xr = 0.5 * (x2 - x1);
+
+            return fixed::Unroll<N, 0, N>::sum(table, [&func, xm, xr](std::uint32_t i) { return func(xm + xr * table.x[i]); }) * xr;
+        }
+
+        //! A private member function (template function).
+        /*!
+            写像したN個の節をまとめて被積分関数に渡して、Gauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussimpl(FUNCTIONAL const & func, double x1, double x2, std::true_type) const
+        {
+            auto const xm = 0.5 * (x1 + x2);
+            auto const xr = 0.5 * (x2 - x1);
+
+            alignas(NodeTable::ALIGNMENT) double x[N];
+            alignas(NodeTable::ALIGNMENT) double y[N];
+            for (auto i = 0U; i < N; i++) {
+                x[i] = xm + xr * table.x[i];
+            }
+
+            func(x, y, static_cast<std::size_t>(N));
+
+            return fixed::Unroll<N, 0, N>::sum(table, [&y](std::uint32_t i) { return y[i]; }) * xr;
+        }
+
+        //! A private member function (template function).
+        /*!
+            写像した節をSIMDベクトルごとに被積分関数に渡して、Gauss-Legendre積分を実行する
+            埋め草の節（重みが0）も評価するので、被積分関数は最後の節での値と同じ有限の値を返す
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussvector(FUNCTIONAL const & func, double x1, double x2, std::false_type) const
+        {
+            using Vector = fixed::Vector;
+            static auto constexpr W = static_cast<std::uint32_t>(sizeof(Vector) / sizeof(double));
+
+            auto const xm = 0.5 * (x1 + x2);
+            auto const xr = 0.5 * (x2 - x1);
+            Vector const vxm(xm), vxr(xr);
+
+            // 節の数はコンパイル時に決まっているので、このループは完全に展開される
+            Vector sum(0.0);
+            for (auto i = 0U; i < N; i += W) {
+                sum += Vector::load(&table.w[i]) * func(vxm + vxr * Vector::load(&table.x[i]));
+            }
+
+            return simd::add_horizontal(sum) * xr;
+        }
+
+        //! A private member function (template function).
+        /*!
+            被積分関数が配列をまとめて評価する形を持つので、N個の節を一度に渡してGauss-Legendre積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        SIMD_FORCEINLINE double qgaussvector(FUNCTIONAL const & func, double x1, double x2, std::true_type) const
+        {
+            return qgaussimpl(func, x1, x2, std::true_type());
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            Gauss-Legendreの節と重み（コンパイル時に計算される）
+        */
+        static constexpr fixed::Table<N> table = fixed::makeTable<N>();
+
+        // #endregion メンバ変数
+    };
+
+    template <std::uint32_t N>
+    constexpr fixed::Table<N> Gauss_Legendre_Fixed<N>::table;
+}
+
+#endif  // _GAUSS_LEGENDRE_FIXED_H_
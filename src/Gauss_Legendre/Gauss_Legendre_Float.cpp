@@ -0,0 +1,42 @@
+﻿/*! \file Gauss_Legendre_Float.cpp
+    \brief 単精度の節と重みのテーブルでGauss-Legendre積分を行うクラスの実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "Gauss_Legendre_Float.h"
+#include "ruleregistry.h"
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+
+namespace gausslegendre {
+    Gauss_Legendre_Float::Gauss_Legendre_Float(std::uint32_t n, Precision precision, Kernel kernel)
+        : kernel_(kernel == Kernel::Auto ? bestKernel() : kernel),
+          precision_(precision)
+    {
+        if (!availableKernel(kernel_)) {
+            throw std::runtime_error(std::string(kernelName(kernel_)) + "カーネルはこのCPUでは使用できない");
+        }
+
+        dispatch_ = dispatchIndex(kernel_, precision_ == Precision::Mixed ? 1 : 0);
+
+        // 倍精度のテーブルから、単精度に丸めた節と重みを作る
+        auto const source = nodeTable(n, Storage::Full);
+        auto const x = source->x();
+        auto const w = source->w();
+        auto const size = source->size();
+        auto const stride = (size + STRIDE - 1) / STRIDE * STRIDE;
+
+        auto const table = std::make_shared<Table>();
+        table->size = size;
+        table->x.assign(stride, size ? static_cast<float>(x[size - 1]) : 0.0f);
+        table->w.assign(stride, 0.0f);
+        table->wd.assign(stride, 0.0);
+        for (auto i = 0U; i < size; i++) {
+            table->x[i] = static_cast<float>(x[i]);
+            table->w[i] = static_cast<float>(w[i]);
+            table->wd[i] = w[i];
+        }
+
+        table_ = table;
+    }
+}
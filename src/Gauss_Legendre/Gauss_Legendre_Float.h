@@ -0,0 +1,589 @@
+﻿/*! \file Gauss_Legendre_Float.h
+    \brief 単精度の節と重みのテーブルでGauss-Legendre積分を行うクラスの宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _GAUSS_LEGENDRE_FLOAT_H_
+#define _GAUSS_LEGENDRE_FLOAT_H_
+
+#pragma once
+
+#include "Functional.h"
+#include "kernel.h"
+#include "nodetable.h"                          // for gausslegendre::NodeTable::ALIGNMENT
+#include "simdvec.h"                            // for simd::F32vec16, simd::F32vec8, simd::F32vec4
+#include <array>                                // for std::array
+#include <cmath>                                // for std::fabs
+#include <cstddef>                              // for std::size_t
+#include <cstdint>                              // for std::uint32_t
+#include <limits>                               // for std::numeric_limits
+#include <memory>                               // for std::shared_ptr
+#include <type_traits>                          // for std::integral_constant
+#include <utility>                              // for std::index_sequence, std::make_index_sequence
+#include <vector>                               // for std::vector
+#include <boost/align/aligned_allocator.hpp>    // for boost::alignment::aligned_allocator
+
+namespace gausslegendre {
+    //! A struct.
+    /*!
+        単精度の積分カーネルによる積分の結果
+    */
+    struct FloatResult final {
+        //! A public member variable.
+        /*!
+            積分値
+        */
+        double value;
+
+        //! A public member variable.
+        /*!
+            積分値の丸め誤差の見積もり
+            被積分関数の値が単精度で正しく丸められていると仮定した上界で、
+            節を単精度に丸めたことによる誤差と、求積則の打ち切り誤差は含まない
+        */
+        double error;
+    };
+
+    //! A class.
+    /*!
+        倍精度の節と重みを単精度に丸めたテーブルで、Gauss-Legendre積分を行うクラス
+        積分カーネルの選び方はGauss_Legendreと同じで、SIMDベクトルの要素数は倍精度の2倍になる
+        Precision::Singleでは重み付きの和も単精度で、Precision::Mixedでは倍精度の重みを使い倍精度で求める
+        被積分関数は単精度で評価される（Functionalの関数は単精度の節をdoubleに変換して呼び出し、値を単精度に丸める）
+    */
+    class Gauss_Legendre_Float final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param n Gauss-Legendreの分点
+            \param precision 積分カーネルの精度
+            \param kernel 使用する積分カーネル（Kernel::Autoなら最良のものを自動で選ぶ）
+            \throw std::runtime_error 指定したカーネルがこのCPUで使用できないとき
+        */
+        explicit Gauss_Legendre_Float(std::uint32_t n, Precision precision = Precision::Single, Kernel kernel = Kernel::Auto);
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            Gauss-Legendre積分を単精度で実行する
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値と、その丸め誤差の見積もり
+        */
+        template <typename FUNCTYPE>
+        FloatResult qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const;
+
+        //! A public member function (template function).
+        /*!
+            Gauss-Legendre積分を単精度で実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F32vec16, simd::F32vec8, simd::F32vec4, floatを引数に取れるもの）
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値と、その丸め誤差の見積もり
+        */
+        template <typename FUNCTYPE>
+        FloatResult qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const;
+
+        //! A public member function.
+        /*!
+            使用する積分カーネルを返す
+            \return 使用する積分カーネル
+        */
+        Kernel kernel() const
+        {
+            return kernel_;
+        }
+
+        //! A public member function.
+        /*!
+            積分カーネルの精度を返す
+            \return 積分カーネルの精度
+        */
+        Precision precision() const
+        {
+            return precision_;
+        }
+
+    private:
+        //! A private template alias.
+        /*!
+            ALIGNMENTバイト境界に揃えた配列
+        */
+        template <typename T>
+        using AlignedVector = std::vector<T, boost::alignment::aligned_allocator<T, NodeTable::ALIGNMENT>>;
+
+        //! A private template alias.
+        /*!
+            重み付きの和を求める関数（qgausskernel）へのポインタ
+        */
+        template <typename FUNCTIONAL>
+        using FloatKernel = FloatResult (Gauss_Legendre_Float::*)(FUNCTIONAL const &, float, float) const;
+
+        //! A struct.
+        /*!
+            単精度の節と重み、倍精度の重みのテーブル
+            配列の長さはSTRIDEの倍数に切り上げ、切り上げた部分の節は最後の節で、重みは0で埋める
+        */
+        struct Table final {
+            //! A public member variable.
+            /*!
+                節と重みの数
+            */
+            std::uint32_t size;
+
+            //! A public member variable.
+            /*!
+                単精度の節
+            */
+            AlignedVector<float> x;
+
+            //! A public member variable.
+            /*!
+                単精度の重み
+            */
+            AlignedVector<float> w;
+
+            //! A public member variable.
+            /*!
+                倍精度の重み（Precision::Mixedで使う）
+            */
+            AlignedVector<double> wd;
+        };
+
+        // #region メンバ関数
+
+        //! A private member function (template function).
+        /*!
+            テーブルのi番目からの節で被積分関数を評価し、累積変数に足し込む
+            \param func 被積分関数
+            \param i 節の番号
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \param sum 単精度の累積変数（MIXEDでないときのみ使用）
+            \param asum 重みと関数値の積の絶対値の累積変数
+            \param lo 下位の要素の倍精度の累積変数（MIXEDのときのみ使用）
+            \param hi 上位の要素の倍精度の累積変数（MIXEDのときのみ使用）
+            \param usefma FMAを使うかどうか
+        */
+        template <bool MIXED, typename VF, typename VD, typename FUNCTIONAL, typename USEFMA>
+        SIMD_FORCEINLINE void accumulate(FUNCTIONAL const & func, std::uint32_t i, VF const & xm, VF const & xr, VF & sum, VF & asum, VD & lo, VD & hi, USEFMA usefma) const;
+
+        //! A private static member function (template function).
+        /*!
+            単精度の節xで被積分関数を評価する（倍精度の関数をdoubleに変換して呼び出す）
+            \param func 被積分関数
+            \param x 節
+            \return f(x)を単精度に丸めた値
+        */
+        template <typename FUNCTYPE>
+        static SIMD_FORCEINLINE float evaluate(myfunctional::Functional<FUNCTYPE> const & func, float x);
+
+        //! A private static member function (template function).
+        /*!
+            単精度の節のSIMDベクトルxで被積分関数を評価する（倍精度の関数に配列をまとめて渡す）
+            \param func 被積分関数
+            \param x 節
+            \return f(x)を単精度に丸めた値
+        */
+        template <typename FUNCTYPE, typename VEC>
+        static SIMD_FORCEINLINE VEC evaluate(myfunctional::Functional<FUNCTYPE> const & func, VEC const & x);
+
+        //! A private static member function (template function).
+        /*!
+            単精度の節xで被積分関数を評価する
+            \param func 被積分関数
+            \param x 節（floatまたはSIMDベクトル）
+            \return f(x)の値
+        */
+        template <typename FUNCTYPE, typename VEC>
+        static SIMD_FORCEINLINE VEC evaluate(myfunctional::VectorFunctional<FUNCTYPE> const & func, VEC const & x);
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字ごとに、qgausskernelの実体へのポインタを並べた表を作る
+            \return qgausskernelの実体へのポインタの表
+        */
+        template <typename FUNCTIONAL, std::size_t... I>
+        static constexpr std::array<FloatKernel<FUNCTIONAL>, sizeof...(I)> kerneltable(std::index_sequence<I...>);
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使って重み付きの和を求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, typename FUNCTIONAL>
+        SIMD_TARGET("avx") FloatResult qgaussavx(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX2命令とFMAを使って重み付きの和を求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, typename FUNCTIONAL>
+        SIMD_TARGET("avx2,fma") FloatResult qgaussavx2(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX-512F命令とFMAを使って重み付きの和を求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") FloatResult qgaussavx512(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            積分を実行し、丸め誤差を見積もる（qgaussの実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値と、その丸め誤差の見積もり
+        */
+        template <typename FUNCTIONAL>
+        FloatResult qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const;
+
+        //! A private member function (template function).
+        /*!
+            KERNELに従って積分カーネルを呼び出す
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, Kernel KERNEL, typename FUNCTIONAL>
+        FloatResult qgausskernel(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずに重み付きの和を求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, typename FUNCTIONAL>
+        FloatResult qgaussscalar(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            単精度のSIMDベクトルの型VFを使って重み付きの和を求める（各積分カーネルの共通部分）
+            MIXEDのときは、関数値を倍精度のSIMDベクトルの型VDの二つに変換して足し込む
+            端数の節は、テーブルの埋め草（最後の節と重み0）をそのまま読む
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <typename VF, typename VD, bool FMA, bool MIXED, typename FUNCTIONAL>
+        SIMD_FORCEINLINE FloatResult qgausssimd(FUNCTIONAL const & func, float xm, float xr) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使って重み付きの和を求める
+            \param func 被積分関数
+            \param xm 積分区間の中点
+            \param xr 積分区間の幅の半分
+            \return 重み付きの和と、重みと関数値の積の絶対値の和（xrは掛けていない）
+        */
+        template <bool MIXED, typename FUNCTIONAL>
+        SIMD_TARGET("sse2") FloatResult qgausssse2(FUNCTIONAL const & func, float xm, float xr) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            積分カーネルが使う独立した累積変数の数
+        */
+        static std::uint32_t constexpr ACCUMULATORS = 4;
+
+        //! A private static member variable (constant).
+        /*!
+            積分カーネルの表の大きさ（精度の数 × 積分カーネルの数）
+        */
+        static std::uint32_t constexpr DISPATCHES = 2 * KERNELS;
+
+        //! A private static member variable (constant).
+        /*!
+            テーブルの配列の長さの単位（最も長い単精度のSIMDベクトルの要素数）
+        */
+        static std::uint32_t constexpr STRIDE = 16;
+
+        //! A private member variable.
+        /*!
+            積分カーネルの表の添字（コンストラクタで、積分カーネルと精度から一度だけ求める）
+        */
+        std::uint32_t dispatch_;
+
+        //! A private member variable.
+        /*!
+            使用する積分カーネル
+        */
+        Kernel kernel_;
+
+        //! A private member variable.
+        /*!
+            積分カーネルの精度
+        */
+        Precision precision_;
+
+        //! A private member variable.
+        /*!
+            節と重みのテーブル（コピーしたオブジェクトの間で共有される）
+        */
+        std::shared_ptr<Table const> table_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Gauss_Legendre_Float() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    template <typename FUNCTYPE>
+    inline FloatResult Gauss_Legendre_Float::qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTYPE>
+    inline FloatResult Gauss_Legendre_Float::qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <bool MIXED, typename VF, typename VD, typename FUNCTIONAL, typename USEFMA>
+    inline void Gauss_Legendre_Float::accumulate(FUNCTIONAL const & func, std::uint32_t i, VF const & xm, VF const & xr, VF & sum, VF & asum, VD & lo, VD & hi, USEFMA usefma) const
+    {
+        static auto constexpr H = static_cast<std::uint32_t>(sizeof(VD) / sizeof(double));
+
+        auto const f = evaluate(func, simd::muladd(VF::load(&table_->x[i]), xr, xm, usefma));
+        auto const w = VF::load(&table_->w[i]);
+        asum = simd::muladd(w, simd::abs(f), asum, usefma);
+        if (MIXED) {
+            lo = simd::muladd(VD::load(&table_->wd[i]), simd::widenlo(f), lo, usefma);
+            hi = simd::muladd(VD::load(&table_->wd[i + H]), simd::widenhi(f), hi, usefma);
+        }
+        else {
+            sum = simd::muladd(w, f, sum, usefma);
+        }
+    }
+
+    template <typename FUNCTYPE>
+    inline float Gauss_Legendre_Float::evaluate(myfunctional::Functional<FUNCTYPE> const & func, float x)
+    {
+        return static_cast<float>(func(static_cast<double>(x)));
+    }
+
+    template <typename FUNCTYPE, typename VEC>
+    inline VEC Gauss_Legendre_Float::evaluate(myfunctional::Functional<FUNCTYPE> const & func, VEC const & x)
+    {
+        static auto constexpr W = sizeof(VEC) / sizeof(float);
+
+        std::array<float, W> xf;
+        std::array<double, W> xd, yd;
+        x.storeu(xf.data());
+        for (std::size_t j = 0; j < W; j++) {
+            xd[j] = static_cast<double>(xf[j]);
+        }
+
+        func(xd.data(), yd.data(), W);
+        for (std::size_t j = 0; j < W; j++) {
+            xf[j] = static_cast<float>(yd[j]);
+        }
+
+        return VEC::loadu(xf.data());
+    }
+
+    template <typename FUNCTYPE, typename VEC>
+    inline VEC Gauss_Legendre_Float::evaluate(myfunctional::VectorFunctional<FUNCTYPE> const & func, VEC const & x)
+    {
+        return VEC(func(x));
+    }
+
+    template <typename FUNCTIONAL, std::size_t... I>
+    inline constexpr std::array<Gauss_Legendre_Float::FloatKernel<FUNCTIONAL>, sizeof...(I)> Gauss_Legendre_Float::kerneltable(std::index_sequence<I...>)
+    {
+        return { { &Gauss_Legendre_Float::qgausskernel<dispatchVariant(I) != 0, dispatchKernel(I), FUNCTIONAL>... } };
+    }
+
+    template <bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgaussavx(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        return qgausssimd<simd::F32vec8, simd::F64vec4, false, MIXED>(func, xm, xr);
+    }
+
+    template <bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgaussavx2(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        return qgausssimd<simd::F32vec8, simd::F64vec4, true, MIXED>(func, xm, xr);
+    }
+
+    template <bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgaussavx512(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        return qgausssimd<simd::F32vec16, simd::F64vec8, true, MIXED>(func, xm, xr);
+    }
+
+    template <typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const
+    {
+        auto const xm = 0.5 * (x1 + x2);
+        auto const xr = 0.5 * (x2 - x1);
+
+        static constexpr auto table = kerneltable<FUNCTIONAL>(std::make_index_sequence<DISPATCHES>());
+        auto const mixed = precision_ == Precision::Mixed;
+        auto const sum = (this->*table[dispatch_])(func, static_cast<float>(xm), static_cast<float>(xr));
+
+        // 丸め誤差の上界の係数（単位は単精度の丸めの単位u = 2^-24）
+        // 単精度の和では、重みの丸めと積の丸めに、一つの累積変数への足し込みの回数を加える
+        // 倍精度の和では、関数値を単精度に丸めたことによる誤差だけが残る
+        auto lanes = 1U;
+        switch (kernel_) {
+        case Kernel::AVX512:
+            lanes = 16;
+            break;
+
+        case Kernel::AVX2:
+        case Kernel::AVX:
+            lanes = 8;
+            break;
+
+        case Kernel::SSE2:
+            lanes = 4;
+            break;
+
+        default:
+            break;
+        }
+
+        auto const chunk = lanes * ACCUMULATORS;
+        auto const factor = mixed ? 1.0 : static_cast<double>((table_->size + chunk - 1) / chunk + 2);
+        auto const u = 0.5 * static_cast<double>(std::numeric_limits<float>::epsilon());
+
+        return { sum.value * xr, factor * u * sum.error * std::fabs(xr) };
+    }
+
+    template <bool MIXED, Kernel KERNEL, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgausskernel(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        switch (KERNEL) {
+        case Kernel::AVX512:
+            return qgaussavx512<MIXED>(func, xm, xr);
+
+        case Kernel::AVX2:
+            return qgaussavx2<MIXED>(func, xm, xr);
+
+        case Kernel::AVX:
+            return qgaussavx<MIXED>(func, xm, xr);
+
+        case Kernel::SSE2:
+            return qgausssse2<MIXED>(func, xm, xr);
+
+        default:
+            return qgaussscalar<MIXED>(func, xm, xr);
+        }
+    }
+
+    template <bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgaussscalar(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        auto const x = table_->x.data();
+        auto const w = table_->w.data();
+        auto const wd = table_->wd.data();
+        auto const size = table_->size;
+
+        std::array<float, ACCUMULATORS> sum, asum;
+        std::array<double, ACCUMULATORS> dsum;
+        sum.fill(0.0f);
+        asum.fill(0.0f);
+        dsum.fill(0.0);
+
+        // 配列の長さはACCUMULATORSの倍数に切り上げてあるので、端数の節も埋め草を読むだけでよい
+        for (auto i = 0U; i < size; i += ACCUMULATORS) {
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                auto const f = evaluate(func, x[i + k] * xr + xm);
+                asum[k] += w[i + k] * std::fabs(f);
+                if (MIXED) {
+                    dsum[k] += wd[i + k] * static_cast<double>(f);
+                }
+                else {
+                    sum[k] += w[i + k] * f;
+                }
+            }
+        }
+
+        auto const value = MIXED ?
+            (dsum[0] + dsum[1]) + (dsum[2] + dsum[3]) :
+            static_cast<double>((sum[0] + sum[1]) + (sum[2] + sum[3]));
+
+        return { value, static_cast<double>((asum[0] + asum[1]) + (asum[2] + asum[3])) };
+    }
+
+    template <typename VF, typename VD, bool FMA, bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgausssimd(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VF) / sizeof(float));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const size = table_->size;
+        VF const vxm(xm), vxr(xr);
+
+        std::array<VF, ACCUMULATORS> sum, asum;
+        std::array<VD, ACCUMULATORS> lo, hi;
+        sum.fill(VF(0.0f));
+        asum.fill(VF(0.0f));
+        lo.fill(VD(0.0));
+        hi.fill(VD(0.0));
+
+        auto i = 0U;
+        for (; i + W * ACCUMULATORS <= size; i += W * ACCUMULATORS) {
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                accumulate<MIXED>(func, i + k * W, vxm, vxr, sum[k], asum[k], lo[k], hi[k], usefma);
+            }
+        }
+
+        // 配列の長さはSTRIDE（>= W）の倍数に切り上げてあるので、端数の節も埋め草を読むだけでよい
+        for (; i < size; i += W) {
+            accumulate<MIXED>(func, i, vxm, vxr, sum[0], asum[0], lo[0], hi[0], usefma);
+        }
+
+        auto const value = MIXED ?
+            simd::add_horizontal(((lo[0] + hi[0]) + (lo[1] + hi[1])) + ((lo[2] + hi[2]) + (lo[3] + hi[3]))) :
+            simd::add_horizontal((sum[0] + sum[1]) + (sum[2] + sum[3]));
+
+        return { value, simd::add_horizontal((asum[0] + asum[1]) + (asum[2] + asum[3])) };
+    }
+
+    template <bool MIXED, typename FUNCTIONAL>
+    inline FloatResult Gauss_Legendre_Float::qgausssse2(FUNCTIONAL const & func, float xm, float xr) const
+    {
+        return qgausssimd<simd::F32vec4, simd::F64vec2, false, MIXED>(func, xm, xr);
+    }
+}
+
+#endif  // _GAUSS_LEGENDRE_FLOAT_H_
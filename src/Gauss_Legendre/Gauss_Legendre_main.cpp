@@ -1,58 +1,81 @@
 ﻿#include "checkpoint.h"
-#include "gauss_Legendre.h"
-#include <array>            // for std::array
-#include <cmath>            // for std::sqrt
-#include <iomanip>
-#include <iostream>
-#include <string>
+#include "benchmark.h"
+#include <fstream>          // for std::ofstream
+#include <iostream>         // for std::cerr, std::cout
+#include <stdexcept>        // for std::invalid_argument
+#include <string>           // for std::string
 
 namespace {
-    static auto constexpr DIGIT = 15U;
-    static auto constexpr LOOPMAX = 1000000000UL;
-    static auto constexpr N = 10001U;
+    //! A function.
+    /*!
+        使い方を表示する
+        \param program プログラム名
+    */
+    void usage(char const * program)
+    {
+        std::cerr << "使い方：" << program << " [--オプション=値...]\n"
+                  << "  --orders=16,128,1001,10001           Gauss-Legendreの分点\n"
+                  << "  --kernels=scalar,sse2,avx,avx2,avx512 積分カーネル\n"
+                  << "  --costs=poly,sqrt,expsin,special     被積分関数の重さ\n"
+                  << "  --batches=1,64                       一回の呼び出しで積分する区間の数\n"
+                  << "  --threads=1,8                        OpenMPのスレッド数\n"
+                  << "  --summations=naive,compensated,doubledouble,reproducible\n"
+                  << "                                       重み付きの和を求める方法\n"
+                  << "  --fixed=on|off                       分点が8, 16, 32, 64のときにGauss_Legendre_Fixedも計測するか\n"
+                  << "  --repetitions=5                      計測の繰り返し回数\n"
+                  << "  --min-time=0.05                      一回の計測の最短時間（秒）\n"
+                  << "  --format=console|json|csv            出力形式\n"
+                  << "  --out=ファイル名                     出力先（省略すると標準出力）\n";
+    }
 }
 
-int main()
+int main(int argc, char * argv[])
 {
-    auto const func = myfunctional::make_functional([](double x) { return 1.0 / (2.0 * std::sqrt(x)); });
-	auto const exact = static_cast<double>(LOOPMAX);
-    std::array<double, 2> res;
+    std::string format, out;
+    gausslegendre::benchmark::Config config;
+    try {
+        config = gausslegendre::benchmark::parseArguments(argc, argv, format, out);
+    }
+    catch (std::invalid_argument const & e) {
+        std::cerr << e.what() << '\n';
+        usage(argv[0]);
+        return 1;
+    }
+
+    // JSONとCSVを標準出力に書くときは、計測の経過を標準エラー出力に回す
+    auto const tostdout = out.empty() && format != "console";
+    auto & progress = tostdout ? std::cerr : std::cout;
 
     checkpoint::CheckPoint chk;
-    
+
     chk.checkpoint("処理開始", __LINE__);
-	
-	gausslegendre::Gauss_Legendre gl(N);
-	
-    chk.checkpoint("Gauss-Legendreの分点を求める処理", __LINE__);
-
-	{
-		auto sum = 0.0;
-        for (auto i = 0UL; i < LOOPMAX; i++) {
-            sum += gl.qgauss(func, false, 1.0, 4.0);
-        }
-		
-		res[0] = sum;
-	}
-
-    chk.checkpoint("AVX無効", __LINE__);
-	
-	{
-		auto sum = 0.0;
-        for (auto i = 0UL; i < LOOPMAX; i++) {
-            sum += gl.qgauss(func, true, 1.0, 4.0);
+
+    auto const results = gausslegendre::benchmark::run(config, progress);
+
+    chk.checkpoint("ベンチマーク", __LINE__);
+
+    if (format != "console") {
+        std::ofstream ofs;
+        if (!out.empty()) {
+            ofs.open(out);
+            if (!ofs) {
+                std::cerr << "ファイルを開けませんでした：" << out << '\n';
+                return 1;
+            }
         }
-		
-		res[1] = sum;
-	}
-	chk.checkpoint("AVX有効", __LINE__);
 
-	chk.checkpoint_print();
+        auto & os = out.empty() ? std::cout : ofs;
+        if (format == "json") {
+            gausslegendre::benchmark::writeJson(os, config, results);
+        }
+        else {
+            gausslegendre::benchmark::writeCsv(os, results);
+        }
+    }
 
-	std::cout.setf(std::ios::fixed, std::ios::floatfield);
-	std::cout << "正確な値：\t" << std::setprecision(DIGIT) << exact  << '\n';
-	std::cout << "AVX無効：\t" << std::setprecision(DIGIT) << res[0] << '\n';
-    std::cout << "AVX有効：\t" << std::setprecision(DIGIT) << res[1] << '\n';
+    if (!tostdout) {
+        chk.checkpoint_print();
+    }
 
-	return 0;
+    return 0;
 }
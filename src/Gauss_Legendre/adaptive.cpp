@@ -0,0 +1,52 @@
+﻿/*! \file adaptive.cpp
+    \brief Gauss-Kronrod則の誤差評価にもとづいて積分区間を適応的に分割する積分クラスの実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "adaptive.h"
+#include "integration.h"
+#include "nodetable.h"
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+
+namespace gausslegendre {
+    Adaptive::Adaptive(std::uint32_t n, std::uint32_t maxsegments, Kernel kernel)
+        : kernel_(kernel == Kernel::Auto ? bestKernel() : kernel),
+          maxsegments_(std::max(maxsegments, 1U))
+    {
+        if (!availableKernel(kernel_)) {
+            throw std::runtime_error(std::string(kernelName(kernel_)) + "カーネルはこのCPUでは使用できない");
+        }
+
+        alglib::ae_int_t info = 0;
+        alglib::real_1d_array x, wkronrod, wgauss;
+        alglib::gkqgenerategausslegendre(n, info, x, wkronrod, wgauss);
+        switch (info) {
+        case 1:
+            break;
+
+        default:
+            throw std::runtime_error("alglib::gkqgenerategausslegendreが失敗");
+            break;
+        }
+
+        x_.assign(x.getcontent(), x.getcontent() + x.length());
+        wkronrod_.assign(wkronrod.getcontent(), wkronrod.getcontent() + wkronrod.length());
+        wgauss_.assign(wgauss.getcontent(), wgauss.getcontent() + wgauss.length());
+
+        // SIMDの積分カーネルが端数を処理しなくて済むように、最も長いSIMDベクトルの要素数の倍数まで
+        // 節は最後の節で、重みは0で埋める（埋め草の節は区間の中にあり、関数値は積分値に寄与しない）
+        size_ = x_.size();
+        auto const stride = NodeTable::strideOf(static_cast<std::uint32_t>(size_));
+        x_.resize(stride, x_.back());
+        wkronrod_.resize(stride, 0.0);
+        wgauss_.resize(stride, 0.0);
+
+        // 配列をまとめて評価する被積分関数の作業領域も、ここで一度だけ確保する
+        xmapped_.resize(size_);
+        fmapped_.resize(size_);
+
+        // 優先度付きキューの領域は、ここで一度だけ確保する
+        heap_.reserve(maxsegments_);
+    }
+}
@@ -0,0 +1,465 @@
+﻿/*! \file adaptive.h
+    \brief Gauss-Kronrod則の誤差評価にもとづいて積分区間を適応的に分割する積分クラスの宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _ADAPTIVE_H_
+#define _ADAPTIVE_H_
+
+#pragma once
+
+#include "Functional.h"
+#include "kernel.h"
+#include "simdvec.h"    // for SIMD_TARGET, simd::F64vec8, simd::F64vec4, simd::F64vec2, simd::add_horizontal
+#include <algorithm>    // for std::max, std::pop_heap, std::push_heap
+#include <cmath>        // for std::fabs
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <type_traits>  // for std::false_type, std::integral_constant, std::true_type
+#include <vector>       // for std::vector
+
+namespace gausslegendre {
+    //! A struct.
+    /*!
+        適応的な積分の結果
+    */
+    struct AdaptiveResult final {
+        //! A public member variable.
+        /*!
+            積分値
+        */
+        double value;
+
+        //! A public member variable.
+        /*!
+            積分値の誤差の推定値
+        */
+        double error;
+
+        //! A public member variable.
+        /*!
+            最終的な小区間の数
+        */
+        std::uint32_t segments;
+
+        //! A public member variable.
+        /*!
+            要求された精度を満たしたかどうか
+        */
+        bool converged;
+    };
+
+    //! A class.
+    /*!
+        Gauss-Kronrod則で小区間ごとの誤差を評価し、誤差が最大の小区間を二等分していく適応的な積分クラス
+        小区間の優先度付きキューはコンストラクタで確保した領域を使い回すので、分割のたびにメモリを確保しない
+        キューはオブジェクトが持つので、複数のスレッドから使うときはスレッドごとにコピーすること
+        VectorFunctionalの被積分関数は、写像したGauss-Kronrod則の節をSIMDベクトルごとにまとめて評価し、
+        Gauss-Kronrod則とGauss則の二組の重みの和を同じループで求める
+    */
+    class Adaptive final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param n Gauss-Kronrod則の節の数（3以上の奇数、n / 2点のGauss則を含む）
+            \param maxsegments 小区間の数の上限
+            \param kernel VectorFunctionalの被積分関数を評価する積分カーネル
+            \throw std::runtime_error 節と重みを求められなかったとき、または指定したカーネルがこのCPUで使用できないとき
+        */
+        explicit Adaptive(std::uint32_t n = 15, std::uint32_t maxsegments = 1000, Kernel kernel = Kernel::Auto);
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            誤差の推定値がmax(epsabs, epsrel * |積分値|)以下になるまで、適応的に積分を実行する
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param epsabs 要求する絶対誤差
+            \param epsrel 要求する相対誤差
+            \return 積分の結果
+        */
+        template <typename FUNCTYPE>
+        AdaptiveResult integrate(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2, double epsabs, double epsrel);
+
+        //! A public member function (template function).
+        /*!
+            誤差の推定値がmax(epsabs, epsrel * |積分値|)以下になるまで、適応的に積分を実行する
+            被積分関数は、小区間ごとにSIMDベクトル（配列をまとめて評価する形を持つときは節の配列）でまとめて評価する
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param epsabs 要求する絶対誤差
+            \param epsrel 要求する相対誤差
+            \return 積分の結果
+        */
+        template <typename FUNCTYPE>
+        AdaptiveResult integrate(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2, double epsabs, double epsrel);
+
+    private:
+        //! A struct.
+        /*!
+            優先度付きキューに格納する小区間
+        */
+        struct Segment final {
+            //! A public member variable.
+            /*!
+                小区間の下端
+            */
+            double a;
+
+            //! A public member variable.
+            /*!
+                小区間の上端
+            */
+            double b;
+
+            //! A public member variable.
+            /*!
+                小区間の積分値（Gauss-Kronrod則）
+            */
+            double value;
+
+            //! A public member variable.
+            /*!
+                小区間の積分値の誤差の推定値
+            */
+            double error;
+        };
+
+        //! A private static member function.
+        /*!
+            小区間の優先度を比較する（誤差が大きいほど優先される）
+            \param lhs 左辺の小区間
+            \param rhs 右辺の小区間
+            \return lhsの誤差がrhsの誤差より小さいかどうか
+        */
+        static bool lesserror(Segment const & lhs, Segment const & rhs)
+        {
+            return lhs.error < rhs.error;
+        }
+
+        //! A private member function (template function).
+        /*!
+            小区間[a, b]にGauss-Kronrod則とGauss則を適用する（被積分関数を節ごとに呼び出す）
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        Segment evaluate(FUNCTIONAL const & func, double a, double b);
+
+        //! A private member function (template function).
+        /*!
+            小区間[a, b]にGauss-Kronrod則とGauss則を適用する（kernel_の積分カーネルで、SIMDベクトルごとに被積分関数を呼び出す）
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        Segment evaluatevector(FUNCTIONAL const & func, double a, double b, std::false_type);
+
+        //! A private member function (template function).
+        /*!
+            小区間[a, b]にGauss-Kronrod則とGauss則を適用する（写像した節をまとめて被積分関数に渡す）
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        Segment evaluatevector(FUNCTIONAL const & func, double a, double b, std::true_type);
+
+        //! A private member function (template function).
+        /*!
+            AVX-512命令を使って、小区間[a, b]にGauss-Kronrod則とGauss則を適用する
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") Segment evaluateavx512(FUNCTIONAL const & func, double a, double b) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使って、小区間[a, b]にGauss-Kronrod則とGauss則を適用する
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("avx") Segment evaluateavx(FUNCTIONAL const & func, double a, double b) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使って、小区間[a, b]にGauss-Kronrod則とGauss則を適用する
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("sse2") Segment evaluatesse2(FUNCTIONAL const & func, double a, double b) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使って、小区間[a, b]にGauss-Kronrod則とGauss則を適用する
+            節と重みの配列はVECの要素数の倍数に埋め草を足してあるので、端数の処理はしない
+            \param func 被積分関数
+            \param a 小区間の下端
+            \param b 小区間の上端
+            \return 積分値と誤差の推定値を格納した小区間
+        */
+        template <typename VEC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE Segment evaluatesimd(FUNCTIONAL const & func, double a, double b) const;
+
+        //! A private member function (template function).
+        /*!
+            適応的に積分を実行する（integrateの実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \param epsabs 要求する絶対誤差
+            \param epsrel 要求する相対誤差
+            \param evaluator 被積分関数と小区間の両端を受け取り、小区間にGauss-Kronrod則とGauss則を適用する関数
+            \return 積分の結果
+        */
+        template <typename FUNCTIONAL, typename EVALUATOR>
+        AdaptiveResult integrateimpl(FUNCTIONAL const & func, double x1, double x2, double epsabs, double epsrel, EVALUATOR const & evaluator);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            VectorFunctionalの被積分関数を評価する積分カーネル
+        */
+        Kernel kernel_;
+
+        //! A private member variable.
+        /*!
+            小区間の数の上限
+        */
+        std::uint32_t maxsegments_;
+
+        //! A private member variable.
+        /*!
+            Gauss-Kronrod則の節の数（x_、wgauss_、wkronrod_の埋め草を除いた長さ）
+        */
+        std::size_t size_;
+
+        //! A private member variable.
+        /*!
+            小区間の優先度付きキュー（二分ヒープ、領域はコンストラクタで確保する）
+        */
+        std::vector<Segment> heap_;
+
+        //! A private member variable.
+        /*!
+            Gauss-Kronrod則の節（[-1, 1]、昇順、最も長いSIMDベクトルの要素数の倍数まで最後の節で埋める）
+        */
+        std::vector<double> x_;
+
+        //! A private member variable.
+        /*!
+            Gauss則の重み（Kronrod則で追加された節と埋め草では0）
+        */
+        std::vector<double> wgauss_;
+
+        //! A private member variable.
+        /*!
+            Gauss-Kronrod則の重み（埋め草では0）
+        */
+        std::vector<double> wkronrod_;
+
+        //! A private member variable.
+        /*!
+            配列をまとめて評価する被積分関数に渡す、写像した節の作業領域（領域はコンストラクタで確保する）
+        */
+        std::vector<double> xmapped_;
+
+        //! A private member variable.
+        /*!
+            配列をまとめて評価する被積分関数が返す、関数値の作業領域（領域はコンストラクタで確保する）
+        */
+        std::vector<double> fmapped_;
+
+        // #endregion メンバ変数
+    };
+
+    template <typename FUNCTYPE>
+    inline AdaptiveResult Adaptive::integrate(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2, double epsabs, double epsrel)
+    {
+        auto const evaluator = [this](myfunctional::Functional<FUNCTYPE> const & f, double a, double b) {
+            return evaluate(f, a, b);
+        };
+
+        return integrateimpl(func, x1, x2, epsabs, epsrel, evaluator);
+    }
+
+    template <typename FUNCTYPE>
+    inline AdaptiveResult Adaptive::integrate(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2, double epsabs, double epsrel)
+    {
+        auto const evaluator = [this](myfunctional::VectorFunctional<FUNCTYPE> const & f, double a, double b) {
+            return evaluatevector(f, a, b, std::integral_constant<bool, myfunctional::VectorFunctional<FUNCTYPE>::BATCH>());
+        };
+
+        return integrateimpl(func, x1, x2, epsabs, epsrel, evaluator);
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluate(FUNCTIONAL const & func, double a, double b)
+    {
+        auto const xm = 0.5 * (a + b);
+        auto const xr = 0.5 * (b - a);
+
+        auto kronrod = 0.0, gauss = 0.0;
+        for (std::size_t i = 0; i < size_; i++) {
+            auto const f = func(xm + xr * x_[i]);
+            kronrod += wkronrod_[i] * f;
+            gauss += wgauss_[i] * f;
+        }
+
+        return Segment{ a, b, kronrod * xr, std::fabs((kronrod - gauss) * xr) };
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluatevector(FUNCTIONAL const & func, double a, double b, std::false_type)
+    {
+        switch (kernel_) {
+        case Kernel::AVX512:
+            return evaluateavx512(func, a, b);
+
+        case Kernel::AVX2:
+        case Kernel::AVX:
+            return evaluateavx(func, a, b);
+
+        case Kernel::SSE2:
+            return evaluatesse2(func, a, b);
+
+        default:
+            return evaluate(func, a, b);
+        }
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluatevector(FUNCTIONAL const & func, double a, double b, std::true_type)
+    {
+        auto const xm = 0.5 * (a + b);
+        auto const xr = 0.5 * (b - a);
+
+        for (std::size_t i = 0; i < size_; i++) {
+            xmapped_[i] = xm + xr * x_[i];
+        }
+
+        func(xmapped_.data(), fmapped_.data(), size_);
+
+        auto kronrod = 0.0, gauss = 0.0;
+        for (std::size_t i = 0; i < size_; i++) {
+            kronrod += wkronrod_[i] * fmapped_[i];
+            gauss += wgauss_[i] * fmapped_[i];
+        }
+
+        return Segment{ a, b, kronrod * xr, std::fabs((kronrod - gauss) * xr) };
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluateavx512(FUNCTIONAL const & func, double a, double b) const
+    {
+        return evaluatesimd<simd::F64vec8>(func, a, b);
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluateavx(FUNCTIONAL const & func, double a, double b) const
+    {
+        return evaluatesimd<simd::F64vec4>(func, a, b);
+    }
+
+    template <typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluatesse2(FUNCTIONAL const & func, double a, double b) const
+    {
+        return evaluatesimd<simd::F64vec2>(func, a, b);
+    }
+
+    template <typename VEC, typename FUNCTIONAL>
+    inline Adaptive::Segment Adaptive::evaluatesimd(FUNCTIONAL const & func, double a, double b) const
+    {
+        static auto constexpr W = sizeof(VEC) / sizeof(double);
+
+        auto const xm = 0.5 * (a + b);
+        auto const xr = 0.5 * (b - a);
+        VEC const vxm(xm), vxr(xr);
+
+        // 関数値は一度だけ求め、Gauss-Kronrod則とGauss則の両方の重みを同じループで掛けて足し込む
+        VEC kronrod(0.0), gauss(0.0);
+        for (std::size_t i = 0; i < size_; i += W) {
+            auto const f = func(vxm + vxr * VEC::loadu(&x_[i]));
+            kronrod += VEC::loadu(&wkronrod_[i]) * f;
+            gauss += VEC::loadu(&wgauss_[i]) * f;
+        }
+
+        auto const k = simd::add_horizontal(kronrod);
+        auto const g = simd::add_horizontal(gauss);
+        return Segment{ a, b, k * xr, std::fabs((k - g) * xr) };
+    }
+
+    template <typename FUNCTIONAL, typename EVALUATOR>
+    inline AdaptiveResult Adaptive::integrateimpl(FUNCTIONAL const & func, double x1, double x2, double epsabs, double epsrel, EVALUATOR const & evaluator)
+    {
+        heap_.clear();
+        heap_.push_back(evaluator(func, x1, x2));
+
+        auto value = heap_.front().value;
+        auto error = heap_.front().error;
+        auto converged = error <= std::max(epsabs, epsrel * std::fabs(value));
+
+        // 一回の分割で小区間は一つ増えるので、heap_の容量（maxsegments_）を超えることはない
+        while (!converged && heap_.size() < maxsegments_) {
+            std::pop_heap(heap_.begin(), heap_.end(), lesserror);
+            auto const s = heap_.back();
+            heap_.pop_back();
+
+            auto const mid = 0.5 * (s.a + s.b);
+            if (!(s.a < mid && mid < s.b)) {
+                // これ以上分割できない（浮動小数点数の分解能に達した）
+                heap_.push_back(s);
+                std::push_heap(heap_.begin(), heap_.end(), lesserror);
+                break;
+            }
+
+            auto const left = evaluator(func, s.a, mid);
+            auto const right = evaluator(func, mid, s.b);
+            heap_.push_back(left);
+            std::push_heap(heap_.begin(), heap_.end(), lesserror);
+            heap_.push_back(right);
+            std::push_heap(heap_.begin(), heap_.end(), lesserror);
+
+            value += left.value + right.value - s.value;
+            error += left.error + right.error - s.error;
+            converged = error <= std::max(epsabs, epsrel * std::fabs(value));
+        }
+
+        // 差分の更新で溜まった丸め誤差を除くため、最後に全ての小区間について足し直す
+        value = 0.0;
+        error = 0.0;
+        for (auto const & s : heap_) {
+            value += s.value;
+            error += s.error;
+        }
+
+        return AdaptiveResult{ value, error, static_cast<std::uint32_t>(heap_.size()), error <= std::max(epsabs, epsrel * std::fabs(value)) };
+    }
+}
+
+#endif  // _ADAPTIVE_H_
@@ -0,0 +1,734 @@
+﻿/*! \file benchmark.cpp
+    \brief Gauss-Legendre積分のベンチマーク（分点、カーネル、被積分関数の重さ、バッチサイズ、スレッド数、
+    和の取り方の組み合わせを計測し、結果をJSONやCSVで出力する）の実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "benchmark.h"
+#include "Gauss_Legendre.h"
+#include "Gauss_Legendre_Fixed.h"
+#include <algorithm>    // for std::max, std::min, std::remove, std::sort, std::transform
+#include <cctype>       // for std::isdigit, std::tolower
+#include <chrono>       // for std::chrono
+#include <cmath>        // for std::erfc, std::exp, std::isfinite, std::sin, std::sqrt, std::tgamma
+#include <ctime>        // for std::strftime, std::time
+#include <iomanip>      // for std::setprecision
+#include <limits>       // for std::numeric_limits
+#include <ostream>      // for std::ostream
+#include <sstream>      // for std::istringstream, std::ostringstream
+#include <stdexcept>    // for std::invalid_argument, std::logic_error
+
+#ifdef _OPENMP
+    #include <omp.h>    // for omp_get_max_threads, omp_set_num_threads
+#endif
+
+namespace gausslegendre {
+    namespace benchmark {
+        namespace {
+            //! A global variable (constant).
+            /*!
+                積分区間の下端
+            */
+            static auto constexpr X1 = 1.0;
+
+            //! A global variable (constant).
+            /*!
+                積分区間の上端（バッチ積分では区間ごとに少しずつずらす）
+            */
+            static auto constexpr X2 = 4.0;
+
+            //! A global variable (constant).
+            /*!
+                一回の計測で呼び出す回数の上限
+            */
+            static std::uint64_t constexpr MAXITERATIONS = 1000000000;
+
+            //! A function.
+            /*!
+                Gauss_Legendre_Fixedで計測できる分点かどうかを返す
+                \param n Gauss-Legendreの分点
+                \return Gauss_Legendre_Fixedで計測できる分点ならtrue
+            */
+            bool fixedOrder(std::uint32_t n)
+            {
+                return n == 8 || n == 16 || n == 32 || n == 64;
+            }
+
+            //! A function.
+            /*!
+                計測結果の積分カーネルの名前を返す
+                \param result 計測結果
+                \return 積分カーネルの名前（Gauss_Legendre_Fixedなら"Fixed"）
+            */
+            char const * kernelLabel(Result const & result)
+            {
+                return result.fixed ? "Fixed" : kernelName(result.kernel);
+            }
+
+            //! A function.
+            /*!
+                OpenMPで使える最大のスレッド数を返す
+                \return 最大のスレッド数（OpenMPが無効なら1）
+            */
+            std::int32_t maxThreads()
+            {
+#ifdef _OPENMP
+                return omp_get_max_threads();
+#else
+                return 1;
+#endif
+            }
+
+            //! A function.
+            /*!
+                OpenMPのスレッド数を設定する
+                \param threads スレッド数
+            */
+            void setThreads(std::int32_t threads)
+            {
+#ifdef _OPENMP
+                omp_set_num_threads(threads);
+#else
+                static_cast<void>(threads);
+#endif
+            }
+
+            //! A function.
+            /*!
+                重み付きの和を求める方法の名前を返す
+                \param summation 重み付きの和を求める方法
+                \return 重み付きの和を求める方法の名前
+            */
+            char const * summationName(Summation summation)
+            {
+                switch (summation) {
+                case Summation::Compensated:
+                    return "Compensated";
+
+                case Summation::DoubleDouble:
+                    return "DoubleDouble";
+
+                case Summation::Reproducible:
+                    return "Reproducible";
+
+                default:
+                    return "Naive";
+                }
+            }
+
+            //! A function.
+            /*!
+                カンマ区切りの文字列を分割し、要素を一つずつ変換する
+                \param value カンマ区切りの文字列
+                \param parse 要素を変換する関数
+                \return 変換した要素の配列
+                \throw std::invalid_argument 要素が空のとき
+            */
+            template <typename T, typename PARSE>
+            std::vector<T> parseList(std::string const & value, PARSE parse)
+            {
+                std::vector<T> list;
+                std::istringstream is(value);
+                std::string item;
+                while (std::getline(is, item, ',')) {
+                    list.push_back(parse(item));
+                }
+
+                if (list.empty()) {
+                    throw std::invalid_argument("empty list: " + value);
+                }
+
+                return list;
+            }
+
+            //! A template function.
+            /*!
+                文字列を型Tの正の整数に変換する
+                \param value 文字列（十進数の数字だけからなること）
+                \return 変換した整数
+                \throw std::invalid_argument 正の整数でないか、Tで表せないとき
+            */
+            template <typename T>
+            T parsePositive(std::string const & value)
+            {
+                // std::stoullは先頭の空白と符号を読み飛ばし、負の数も巻き戻して受け付けるので、先頭は数字に限る
+                if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+                    throw std::invalid_argument("not a positive integer: " + value);
+                }
+
+                std::size_t pos = 0;
+                unsigned long long n;
+                try {
+                    n = std::stoull(value, &pos);
+                }
+                catch (std::logic_error const &) {
+                    // std::invalid_argumentとstd::out_of_range
+                    throw std::invalid_argument("not a positive integer: " + value);
+                }
+
+                if (!n || pos != value.size() || n > static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+                    throw std::invalid_argument("not a positive integer: " + value);
+                }
+
+                return static_cast<T>(n);
+            }
+
+            //! A function.
+            /*!
+                文字列を積分カーネルに変換する
+                \param value 文字列（"scalar", "sse2", "avx", "avx2", "avx512"）
+                \return 積分カーネル
+                \throw std::invalid_argument 不明な名前のとき
+            */
+            Kernel parseKernel(std::string const & value)
+            {
+                for (auto const kernel : { Kernel::Scalar, Kernel::SSE2, Kernel::AVX, Kernel::AVX2, Kernel::AVX512 }) {
+                    std::string name(kernelName(kernel));
+                    name.erase(std::remove(name.begin(), name.end(), '-'), name.end());
+                    std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+                    if (name == value) {
+                        return kernel;
+                    }
+                }
+
+                throw std::invalid_argument("unknown kernel: " + value);
+            }
+
+            //! A function.
+            /*!
+                文字列を被積分関数の重さに変換する
+                \param value 文字列（"poly", "sqrt", "expsin", "special"）
+                \return 被積分関数の重さ
+                \throw std::invalid_argument 不明な名前のとき
+            */
+            Cost parseCost(std::string const & value)
+            {
+                for (auto const cost : { Cost::Polynomial, Cost::Sqrt, Cost::ExpSin, Cost::Special }) {
+                    if (value == costName(cost)) {
+                        return cost;
+                    }
+                }
+
+                throw std::invalid_argument("unknown cost: " + value);
+            }
+
+            //! A function.
+            /*!
+                文字列を重み付きの和を求める方法に変換する
+                \param value 文字列（"naive", "compensated", "doubledouble", "reproducible"）
+                \return 重み付きの和を求める方法
+                \throw std::invalid_argument 不明な名前のとき
+            */
+            Summation parseSummation(std::string const & value)
+            {
+                for (auto const summation : { Summation::Naive, Summation::Compensated, Summation::DoubleDouble, Summation::Reproducible }) {
+                    std::string name(summationName(summation));
+                    std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+                    if (name == value) {
+                        return summation;
+                    }
+                }
+
+                throw std::invalid_argument("unknown summation: " + value);
+            }
+
+            //! A function.
+            /*!
+                JSONの文字列に使えない文字をエスケープする
+                \param value 文字列
+                \return エスケープした文字列
+            */
+            std::string escapeJson(std::string const & value)
+            {
+                std::string escaped;
+                for (auto const c : value) {
+                    if (c == '"' || c == '\\') {
+                        escaped += '\\';
+                    }
+
+                    escaped += c;
+                }
+
+                return escaped;
+            }
+
+            //! A function (template function).
+            /*!
+                積分を一回呼び出す
+                \param gl Gauss-Legendre積分を行うオブジェクト
+                \param func 被積分関数
+                \param x1 積分の下端の配列
+                \param x2 積分の上端の配列
+                \param result 積分値を格納する配列
+                \return 積分値の和
+            */
+            template <typename FUNCTIONAL>
+            double integrate(Gauss_Legendre const & gl, FUNCTIONAL const & func, std::vector<double> const & x1, std::vector<double> const & x2, std::vector<double> & result)
+            {
+                if (result.size() == 1) {
+                    return gl.qgauss(func, x1[0], x2[0]);
+                }
+
+                gl.qgauss(func, x1.data(), x2.data(), result.data(), result.size());
+
+                auto sum = 0.0;
+                for (auto const r : result) {
+                    sum += r;
+                }
+
+                return sum;
+            }
+
+            //! A function (template function).
+            /*!
+                Gauss_Legendre_Fixedで積分を一回呼び出す（区間のバッチ積分はないので、区間ごとに呼び出す）
+                \param gl Gauss-Legendre積分を行うオブジェクト
+                \param func 被積分関数
+                \param x1 積分の下端の配列
+                \param x2 積分の上端の配列
+                \param result 積分値を格納する配列
+                \return 積分値の和
+            */
+            template <std::uint32_t N, typename FUNCTIONAL>
+            double integrate(Gauss_Legendre_Fixed<N> const & gl, FUNCTIONAL const & func, std::vector<double> const & x1, std::vector<double> const & x2, std::vector<double> & result)
+            {
+                auto sum = 0.0;
+                for (std::size_t i = 0; i < result.size(); i++) {
+                    result[i] = gl.qgauss(func, x1[i], x2[i]);
+                    sum += result[i];
+                }
+
+                return sum;
+            }
+
+            //! A function (template function).
+            /*!
+                一回の計測がconfig.mintime秒以上になる呼び出し回数を決めてから、config.repetitions回計測する
+                \param gl Gauss-Legendre積分を行うオブジェクト
+                \param func 被積分関数
+                \param config ベンチマークの設定
+                \param result 計測結果を格納する
+            */
+            template <typename GAUSSLEGENDRE, typename FUNCTIONAL>
+            void measure(GAUSSLEGENDRE const & gl, FUNCTIONAL const & func, Config const & config, Result & result)
+            {
+                std::vector<double> x1(result.batch, X1), x2(result.batch), value(result.batch);
+                for (std::size_t i = 0; i < result.batch; i++) {
+                    x2[i] = X2 + 1.0E-3 * static_cast<double>(i);
+                }
+
+                auto const timed = [&](std::uint64_t iterations) {
+                    auto sum = 0.0;
+                    auto const begin = std::chrono::steady_clock::now();
+                    for (std::uint64_t i = 0; i < iterations; i++) {
+                        sum += integrate(gl, func, x1, x2, value);
+                    }
+
+                    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - begin;
+                    result.value = sum / static_cast<double>(iterations * result.batch);
+                    return elapsed.count();
+                };
+
+                // Google Benchmarkと同じように、最短時間に届くまで呼び出し回数を増やす
+                std::uint64_t iterations = 1;
+                for (;;) {
+                    auto const elapsed = timed(iterations);
+                    if (elapsed >= config.mintime || iterations >= MAXITERATIONS) {
+                        break;
+                    }
+
+                    auto const scale = elapsed > 0.0 ? 1.4 * config.mintime / elapsed : 10.0;
+                    auto const next = static_cast<std::uint64_t>(static_cast<double>(iterations) * std::min(scale, 10.0));
+                    iterations = std::min(std::max(next, iterations + 1), MAXITERATIONS);
+                }
+
+                auto const nodes = static_cast<double>(iterations) * static_cast<double>(result.n) * static_cast<double>(result.batch);
+                result.iterations = iterations;
+                for (auto r = 0; r < config.repetitions; r++) {
+                    result.samples.push_back(timed(iterations) * 1.0E9 / nodes);
+                }
+            }
+
+            //! A function.
+            /*!
+                各回の計測から平均値、中央値、標準偏差、最小値、GFLOP/sを求める
+                \param result 計測結果
+            */
+            void summarize(Result & result)
+            {
+                auto sorted = result.samples;
+                std::sort(sorted.begin(), sorted.end());
+                auto const count = sorted.size();
+
+                auto sum = 0.0;
+                for (auto const s : sorted) {
+                    sum += s;
+                }
+
+                result.mean = sum / static_cast<double>(count);
+                result.median = count % 2 ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+                result.min = sorted.front();
+
+                auto var = 0.0;
+                for (auto const s : sorted) {
+                    var += (s - result.mean) * (s - result.mean);
+                }
+
+                result.stddev = count > 1 ? std::sqrt(var / static_cast<double>(count - 1)) : 0.0;
+                result.gflops = static_cast<double>(flopsPerNode(result.cost)) / result.median;
+            }
+
+            //! A function (template function).
+            /*!
+                result.costの被積分関数で計測し、計測結果をまとめる
+                \param gl Gauss-Legendre積分を行うオブジェクト
+                \param config ベンチマークの設定
+                \param result 計測結果を格納する
+            */
+            template <typename GAUSSLEGENDRE>
+            void measureCost(GAUSSLEGENDRE const & gl, Config const & config, Result & result)
+            {
+                switch (result.cost) {
+                case Cost::Polynomial:
+                    measure(gl, myfunctional::make_vectorfunctional([](auto x) {
+                        return ((((((3.0 * x - 2.0) * x + 3.0) * x - 4.0) * x + 5.0) * x - 6.0) * x + 7.0) * x - 8.0;
+                    }), config, result);
+                    break;
+
+                case Cost::Sqrt:
+                    measure(gl, myfunctional::make_vectorfunctional([](auto x) {
+                        using std::sqrt;
+                        return 1.0 / (2.0 * sqrt(x));
+                    }), config, result);
+                    break;
+
+                case Cost::ExpSin:
+                    measure(gl, myfunctional::make_functional([](double x) {
+                        return std::exp(-x) * std::sin(10.0 * x);
+                    }), config, result);
+                    break;
+
+                default:
+                    measure(gl, myfunctional::make_functional([](double x) {
+                        return std::tgamma(1.0 + x) * std::erfc(x);
+                    }), config, result);
+                    break;
+                }
+
+                summarize(result);
+            }
+
+            //! A function.
+            /*!
+                一つの組み合わせを計測する
+                \param result 組み合わせ（n, kernel, cost, batch, threads, summationを設定しておく）
+                \param config ベンチマークの設定
+            */
+            void runCase(Result & result, Config const & config)
+            {
+                std::ostringstream name;
+                name << "qgauss/n:" << result.n
+                     << "/kernel:" << kernelName(result.kernel)
+                     << "/cost:" << costName(result.cost)
+                     << "/batch:" << result.batch
+                     << "/threads:" << result.threads
+                     << "/summation:" << summationName(result.summation);
+                result.name = name.str();
+
+                setThreads(result.threads);
+                Gauss_Legendre const gl(result.n, result.kernel, result.summation, Storage::Full,
+                    result.threads > 1 ? Execution::Parallel : Execution::Sequential);
+
+                measureCost(gl, config, result);
+            }
+
+            //! A function.
+            /*!
+                一つの組み合わせをGauss_Legendre_Fixedで計測する
+                \param result 組み合わせ（n（fixedOrder()がtrueになる値）, cost, batchを設定しておく）
+                \param config ベンチマークの設定
+            */
+            void runFixedCase(Result & result, Config const & config)
+            {
+                std::ostringstream name;
+                name << "qgauss_fixed/n:" << result.n
+                     << "/cost:" << costName(result.cost)
+                     << "/batch:" << result.batch;
+                result.name = name.str();
+
+                setThreads(1);
+                switch (result.n) {
+                case 8:
+                    measureCost(Gauss_Legendre_Fixed<8>(), config, result);
+                    break;
+
+                case 16:
+                    measureCost(Gauss_Legendre_Fixed<16>(), config, result);
+                    break;
+
+                case 32:
+                    measureCost(Gauss_Legendre_Fixed<32>(), config, result);
+                    break;
+
+                default:
+                    measureCost(Gauss_Legendre_Fixed<64>(), config, result);
+                    break;
+                }
+            }
+        }
+
+        char const * costName(Cost cost)
+        {
+            switch (cost) {
+            case Cost::Polynomial:
+                return "poly";
+
+            case Cost::Sqrt:
+                return "sqrt";
+
+            case Cost::ExpSin:
+                return "expsin";
+
+            default:
+                return "special";
+            }
+        }
+
+        Config defaultConfig()
+        {
+            Config config;
+            config.orders = { 16, 128, 1001, 10001 };
+            config.kernels = { Kernel::Scalar, Kernel::SSE2, Kernel::AVX, Kernel::AVX2, Kernel::AVX512 };
+            config.costs = { Cost::Polynomial, Cost::Sqrt, Cost::ExpSin, Cost::Special };
+            config.batches = { 1, 64 };
+            config.threads = { 1 };
+            if (maxThreads() > 1) {
+                config.threads.push_back(maxThreads());
+            }
+
+            config.summations = { Summation::Naive };
+            config.fixed = true;
+            config.repetitions = 5;
+            config.mintime = 0.05;
+
+            return config;
+        }
+
+        std::uint32_t flopsPerNode(Cost cost)
+        {
+            switch (cost) {
+            case Cost::Polynomial:
+                return 4 + 14;
+
+            case Cost::Sqrt:
+                return 4 + 3;
+
+            case Cost::ExpSin:
+                return 4 + 4;
+
+            default:
+                return 4 + 4;
+            }
+        }
+
+        Config parseArguments(int argc, char * argv[], std::string & format, std::string & out)
+        {
+            auto config = defaultConfig();
+            format = "console";
+            out.clear();
+
+            for (auto i = 1; i < argc; i++) {
+                std::string const arg(argv[i]);
+                auto const eq = arg.find('=');
+                if (arg.compare(0, 2, "--") || eq == std::string::npos) {
+                    throw std::invalid_argument("unknown argument: " + arg);
+                }
+
+                auto const key = arg.substr(2, eq - 2);
+                auto const value = arg.substr(eq + 1);
+                if (key == "orders") {
+                    config.orders = parseList<std::uint32_t>(value, parsePositive<std::uint32_t>);
+                }
+                else if (key == "kernels") {
+                    config.kernels = parseList<Kernel>(value, parseKernel);
+                }
+                else if (key == "costs") {
+                    config.costs = parseList<Cost>(value, parseCost);
+                }
+                else if (key == "batches") {
+                    config.batches = parseList<std::size_t>(value, parsePositive<std::size_t>);
+                }
+                else if (key == "threads") {
+                    config.threads = parseList<std::int32_t>(value, parsePositive<std::int32_t>);
+                }
+                else if (key == "summations") {
+                    config.summations = parseList<Summation>(value, parseSummation);
+                }
+                else if (key == "fixed") {
+                    if (value != "on" && value != "off") {
+                        throw std::invalid_argument("not on or off: " + value);
+                    }
+
+                    config.fixed = value == "on";
+                }
+                else if (key == "repetitions") {
+                    config.repetitions = parsePositive<std::int32_t>(value);
+                }
+                else if (key == "min-time") {
+                    std::size_t pos = 0;
+                    try {
+                        config.mintime = value.empty() ? 0.0 : std::stod(value, &pos);
+                    }
+                    catch (std::logic_error const &) {
+                        config.mintime = 0.0;
+                    }
+
+                    if (!(config.mintime > 0.0) || !std::isfinite(config.mintime) || pos != value.size()) {
+                        throw std::invalid_argument("not a positive time: " + value);
+                    }
+                }
+                else if (key == "format") {
+                    if (value != "console" && value != "json" && value != "csv") {
+                        throw std::invalid_argument("unknown format: " + value);
+                    }
+
+                    format = value;
+                }
+                else if (key == "out") {
+                    out = value;
+                }
+                else {
+                    throw std::invalid_argument("unknown argument: " + arg);
+                }
+            }
+
+            return config;
+        }
+
+        std::vector<Result> run(Config const & config, std::ostream & progress)
+        {
+            std::vector<Result> results;
+            for (auto const n : config.orders) {
+                for (auto const kernel : config.kernels) {
+                    if (!availableKernel(kernel)) {
+                        continue;
+                    }
+
+                    for (auto const cost : config.costs) {
+                        for (auto const batch : config.batches) {
+                            for (auto const threads : config.threads) {
+                                for (auto const summation : config.summations) {
+                                    Result result;
+                                    result.fixed = false;
+                                    result.n = n;
+                                    result.kernel = kernel;
+                                    result.cost = cost;
+                                    result.batch = batch;
+                                    result.threads = threads;
+                                    result.summation = summation;
+                                    runCase(result, config);
+
+                                    writeLine(progress, result);
+                                    results.push_back(std::move(result));
+                                }
+                            }
+                        }
+                    }
+                }
+
+                // Gauss_Legendre_Fixedはカーネル、スレッド数、和の取り方を選べないので、分点ごとに一度だけ計測する
+                if (config.fixed && fixedOrder(n)) {
+                    for (auto const cost : config.costs) {
+                        for (auto const batch : config.batches) {
+                            Result result;
+                            result.fixed = true;
+                            result.n = n;
+                            result.kernel = Kernel::Auto;
+                            result.cost = cost;
+                            result.batch = batch;
+                            result.threads = 1;
+                            result.summation = Summation::Naive;
+                            runFixedCase(result, config);
+
+                            writeLine(progress, result);
+                            results.push_back(std::move(result));
+                        }
+                    }
+                }
+            }
+
+            setThreads(maxThreads());
+            return results;
+        }
+
+        void writeCsv(std::ostream & os, std::vector<Result> const & results)
+        {
+            os << "name,n,kernel,cost,batch,threads,summation,iterations,repetitions,"
+               << "mean_ns_per_node,median_ns_per_node,stddev_ns_per_node,min_ns_per_node,gflops,value\n";
+            for (auto const & r : results) {
+                os << r.name << ',' << r.n << ',' << kernelLabel(r) << ',' << costName(r.cost) << ','
+                   << r.batch << ',' << r.threads << ',' << summationName(r.summation) << ','
+                   << r.iterations << ',' << r.samples.size() << ','
+                   << std::setprecision(6) << r.mean << ',' << r.median << ',' << r.stddev << ',' << r.min << ','
+                   << r.gflops << ',' << std::setprecision(17) << r.value << '\n';
+            }
+        }
+
+        void writeJson(std::ostream & os, Config const & config, std::vector<Result> const & results)
+        {
+            char date[32];
+            auto const now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            os << "{\n"
+               << "  \"context\": {\n"
+               << "    \"date\": \"" << date << "\",\n"
+               << "    \"best_kernel\": \"" << kernelName(bestKernel()) << "\",\n"
+               << "    \"max_threads\": " << maxThreads() << ",\n"
+               << "    \"repetitions\": " << config.repetitions << ",\n"
+               << "    \"min_time\": " << config.mintime << "\n"
+               << "  },\n"
+               << "  \"benchmarks\": [";
+
+            for (std::size_t i = 0; i < results.size(); i++) {
+                auto const & r = results[i];
+                os << (i ? ",\n" : "\n")
+                   << "    {\n"
+                   << "      \"name\": \"" << escapeJson(r.name) << "\",\n"
+                   << "      \"n\": " << r.n << ",\n"
+                   << "      \"kernel\": \"" << kernelLabel(r) << "\",\n"
+                   << "      \"cost\": \"" << costName(r.cost) << "\",\n"
+                   << "      \"batch\": " << r.batch << ",\n"
+                   << "      \"threads\": " << r.threads << ",\n"
+                   << "      \"summation\": \"" << summationName(r.summation) << "\",\n"
+                   << "      \"iterations\": " << r.iterations << ",\n"
+                   << std::setprecision(6)
+                   << "      \"ns_per_node\": {\"mean\": " << r.mean << ", \"median\": " << r.median
+                   << ", \"stddev\": " << r.stddev << ", \"min\": " << r.min << "},\n"
+                   << "      \"samples\": [";
+                for (std::size_t j = 0; j < r.samples.size(); j++) {
+                    os << (j ? ", " : "") << r.samples[j];
+                }
+
+                os << "],\n"
+                   << "      \"flops_per_node\": " << flopsPerNode(r.cost) << ",\n"
+                   << "      \"gflops\": " << r.gflops << ",\n"
+                   << "      \"value\": " << std::setprecision(17) << r.value << "\n"
+                   << "    }";
+            }
+
+            os << "\n  ]\n}\n";
+        }
+
+        void writeLine(std::ostream & os, Result const & result)
+        {
+            auto const cv = result.mean > 0.0 ? 100.0 * result.stddev / result.mean : 0.0;
+            os << std::left << std::setw(80) << result.name << std::right
+               << std::fixed << std::setprecision(3)
+               << std::setw(10) << result.median << " ns/node "
+               << std::setw(9) << result.gflops << " GFLOP/s "
+               << "(±" << std::setprecision(1) << cv << "%, " << result.iterations << " iterations)\n";
+            os.unsetf(std::ios::floatfield);
+        }
+    }
+}
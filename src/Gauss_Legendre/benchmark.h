@@ -0,0 +1,274 @@
+﻿/*! \file benchmark.h
+    \brief Gauss-Legendre積分のベンチマーク（分点、カーネル、被積分関数の重さ、バッチサイズ、スレッド数、
+    和の取り方の組み合わせを計測し、結果をJSONやCSVで出力する）の宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#pragma once
+
+#include "kernel.h"
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t, std::uint64_t
+#include <iosfwd>       // for std::ostream
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+namespace gausslegendre {
+    namespace benchmark {
+        //! A enumeration.
+        /*!
+            被積分関数の重さ
+        */
+        enum class Cost : std::int32_t {
+            //! 7次の多項式（SIMDベクトル版の被積分関数）
+            Polynomial,
+
+            //! 1 / (2√x)（SIMDベクトル版の被積分関数）
+            Sqrt,
+
+            //! exp(-x)sin(10x)（スカラー版の被積分関数）
+            ExpSin,
+
+            //! Γ(1 + x)erfc(x)（スカラー版の被積分関数）
+            Special
+        };
+
+        //! A struct.
+        /*!
+            ベンチマークの設定
+            各配列の要素の全ての組み合わせを一つずつ計測する
+        */
+        struct Config final {
+            //! A public member variable.
+            /*!
+                Gauss-Legendreの分点
+            */
+            std::vector<std::uint32_t> orders;
+
+            //! A public member variable.
+            /*!
+                積分カーネル（このCPUで使用できないものは飛ばす）
+            */
+            std::vector<Kernel> kernels;
+
+            //! A public member variable.
+            /*!
+                被積分関数の重さ
+            */
+            std::vector<Cost> costs;
+
+            //! A public member variable.
+            /*!
+                一回の呼び出しで積分する区間の数（1なら一つの区間の積分、2以上なら区間のバッチ積分）
+            */
+            std::vector<std::size_t> batches;
+
+            //! A public member variable.
+            /*!
+                OpenMPのスレッド数（1ならExecution::Sequential、2以上ならExecution::Parallel）
+            */
+            std::vector<std::int32_t> threads;
+
+            //! A public member variable.
+            /*!
+                重み付きの和を求める方法
+            */
+            std::vector<Summation> summations;
+
+            //! A public member variable.
+            /*!
+                分点がGauss_Legendre_Fixedで計測できる値（8, 16, 32, 64）のとき、Gauss_Legendre_Fixedも計測するかどうか
+            */
+            bool fixed;
+
+            //! A public member variable.
+            /*!
+                計測の繰り返し回数
+            */
+            std::int32_t repetitions;
+
+            //! A public member variable.
+            /*!
+                一回の計測の最短時間（秒）
+            */
+            double mintime;
+        };
+
+        //! A struct.
+        /*!
+            一つの組み合わせの計測結果
+        */
+        struct Result final {
+            //! A public member variable.
+            /*!
+                組み合わせの名前（"qgauss/n:10001/kernel:AVX2/..."、Gauss_Legendre_Fixedなら"qgauss_fixed/n:16/..."）
+            */
+            std::string name;
+
+            //! A public member variable.
+            /*!
+                Gauss_Legendre_Fixedで計測したかどうか（kernel、threads、summationは使わない）
+            */
+            bool fixed;
+
+            //! A public member variable.
+            /*!
+                Gauss-Legendreの分点
+            */
+            std::uint32_t n;
+
+            //! A public member variable.
+            /*!
+                積分カーネル
+            */
+            Kernel kernel;
+
+            //! A public member variable.
+            /*!
+                被積分関数の重さ
+            */
+            Cost cost;
+
+            //! A public member variable.
+            /*!
+                一回の呼び出しで積分する区間の数
+            */
+            std::size_t batch;
+
+            //! A public member variable.
+            /*!
+                OpenMPのスレッド数
+            */
+            std::int32_t threads;
+
+            //! A public member variable.
+            /*!
+                重み付きの和を求める方法
+            */
+            Summation summation;
+
+            //! A public member variable.
+            /*!
+                一回の計測で呼び出した回数
+            */
+            std::uint64_t iterations;
+
+            //! A public member variable.
+            /*!
+                各回の計測の、節一つあたりの時間（ナノ秒）
+            */
+            std::vector<double> samples;
+
+            //! A public member variable.
+            /*!
+                節一つあたりの時間の平均値（ナノ秒）
+            */
+            double mean;
+
+            //! A public member variable.
+            /*!
+                節一つあたりの時間の中央値（ナノ秒）
+            */
+            double median;
+
+            //! A public member variable.
+            /*!
+                節一つあたりの時間の標準偏差（ナノ秒）
+            */
+            double stddev;
+
+            //! A public member variable.
+            /*!
+                節一つあたりの時間の最小値（ナノ秒）
+            */
+            double min;
+
+            //! A public member variable.
+            /*!
+                中央値から求めた浮動小数点演算の速度（GFLOP/s、flopsPerNode()の演算数で数える）
+            */
+            double gflops;
+
+            //! A public member variable.
+            /*!
+                最後に求めた積分値（計測が最適化で消されないように使う）
+            */
+            double value;
+        };
+
+        //! A function.
+        /*!
+            被積分関数の重さの名前を返す
+            \param cost 被積分関数の重さ
+            \return 被積分関数の重さの名前
+        */
+        char const * costName(Cost cost);
+
+        //! A function.
+        /*!
+            既定のベンチマークの設定を返す
+            \return 既定のベンチマークの設定
+        */
+        Config defaultConfig();
+
+        //! A function.
+        /*!
+            節一つあたりの浮動小数点演算の数を返す
+            区間への写像と重みの積和を4演算とし、sqrt、除算、exp、sin、tgamma、erfcはそれぞれ1演算と数える
+            \param cost 被積分関数の重さ
+            \return 節一つあたりの浮動小数点演算の数
+        */
+        std::uint32_t flopsPerNode(Cost cost);
+
+        //! A function.
+        /*!
+            コマンドライン引数からベンチマークの設定を作る
+            \param argc コマンドライン引数の数
+            \param argv コマンドライン引数
+            \param format 出力形式（"console", "json", "csv"）を格納する
+            \param out 出力先のファイル名（空なら標準出力）を格納する
+            \return ベンチマークの設定
+            \throw std::invalid_argument 引数が正しくないとき
+        */
+        Config parseArguments(int argc, char * argv[], std::string & format, std::string & out);
+
+        //! A function.
+        /*!
+            設定の全ての組み合わせを計測する
+            \param config ベンチマークの設定
+            \param progress 計測の経過を出力するストリーム
+            \return 計測結果
+        */
+        std::vector<Result> run(Config const & config, std::ostream & progress);
+
+        //! A function.
+        /*!
+            計測結果をCSV形式で出力する
+            \param os 出力先のストリーム
+            \param results 計測結果
+        */
+        void writeCsv(std::ostream & os, std::vector<Result> const & results);
+
+        //! A function.
+        /*!
+            計測結果をJSON形式で出力する
+            \param os 出力先のストリーム
+            \param config ベンチマークの設定
+            \param results 計測結果
+        */
+        void writeJson(std::ostream & os, Config const & config, std::vector<Result> const & results);
+
+        //! A function.
+        /*!
+            計測結果の一行を、人間が読むための形式で出力する
+            \param os 出力先のストリーム
+            \param result 計測結果
+        */
+        void writeLine(std::ostream & os, Result const & result);
+    }
+}
+
+#endif  // _BENCHMARK_H_
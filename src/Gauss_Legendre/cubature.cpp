@@ -0,0 +1,120 @@
+﻿/*! \file cubature.cpp
+    \brief Gauss-Legendre則のテンソル積と疎格子（Smolyak）による多次元積分クラスの実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "cubature.h"
+#include "ruleregistry.h"
+#include <stdexcept>    // for std::runtime_error
+
+namespace gausslegendre {
+    Cubature::Cubature(std::uint32_t dim, std::uint32_t level, Grid grid)
+        : dim_(dim)
+    {
+        if (!dim || !level) {
+            throw std::runtime_error("次元とレベルは1以上でなければならない");
+        }
+
+        // 積分のたびに使う作業領域は、ここで一度だけ確保する
+        xm_.resize(dim_);
+        xr_.resize(dim_);
+        buf_.resize(BLOCK * dim_);
+        y_.resize(BLOCK);
+
+        switch (grid) {
+        case Grid::TensorProduct:
+            append(std::vector<std::uint32_t>(dim, level), 1.0);
+            break;
+
+        case Grid::Smolyak:
+            smolyak(level);
+            break;
+
+        default:
+            throw std::runtime_error("不明な格子の種類");
+            break;
+        }
+    }
+
+    void Cubature::append(std::vector<std::uint32_t> const & orders, double scale)
+    {
+        std::vector<std::shared_ptr<NodeTable const>> rules(dim_);
+        std::size_t count = 1;
+        for (auto k = 0U; k < dim_; k++) {
+            rules[k] = nodeTable(orders[k], Storage::Full);
+            if (count > MAXPOINTS / orders[k]) {
+                throw std::runtime_error("格子の点が多すぎる");
+            }
+
+            count *= orders[k];
+        }
+
+        if (w_.size() + count > MAXPOINTS) {
+            throw std::runtime_error("格子の点が多すぎる");
+        }
+
+        x_.reserve(x_.size() + count * dim_);
+        w_.reserve(w_.size() + count);
+
+        // 多重添字indexを最後の次元が最も速く変わる順に数え上げる
+        std::vector<std::uint32_t> index(dim_, 0);
+        for (std::size_t p = 0; p < count; p++) {
+            auto w = scale;
+            for (auto k = 0U; k < dim_; k++) {
+                x_.push_back(rules[k]->x()[index[k]]);
+                w *= rules[k]->w()[index[k]];
+            }
+
+            w_.push_back(w);
+
+            for (auto k = dim_; k-- > 0;) {
+                if (++index[k] < orders[k]) {
+                    break;
+                }
+
+                index[k] = 0;
+            }
+        }
+    }
+
+    void Cubature::smolyak(std::uint32_t level)
+    {
+        // A(q, d) = Σ_{q - d + 1 ≤ |i| ≤ q} (-1)^(q - |i|) C(d - 1, q - |i|) U^(i_1) ⊗ … ⊗ U^(i_d)、q = level + d - 1
+        // 一次元の則U^(i)はi点のGauss-Legendre則で、次数2i - 1まで厳密である
+        auto const q = level + dim_ - 1;
+
+        // 二項係数C(d - 1, j)（j = 0, …, d - 1）
+        std::vector<double> binomial(dim_, 1.0);
+        for (auto j = 1U; j < dim_; j++) {
+            binomial[j] = binomial[j - 1] * static_cast<double>(dim_ - j) / static_cast<double>(j);
+        }
+
+        // 各成分が1以上で、和が[q - d + 1, q]に入る多重添字を全て数え上げる
+        std::vector<std::uint32_t> index(dim_, 1);
+        auto total = dim_;
+        for (;;) {
+            if (total + dim_ > q) {
+                auto const j = q - total;
+                auto const sign = (j & 0x01) ? -1.0 : 1.0;
+                append(index, sign * binomial[j]);
+            }
+
+            // 次の多重添字（和がqを超えたら、その成分を1に戻して次の成分へ繰り上げる）
+            auto k = 0U;
+            for (; k < dim_; k++) {
+                if (total < q) {
+                    index[k]++;
+                    total++;
+                    break;
+                }
+
+                total -= index[k] - 1;
+                index[k] = 1;
+            }
+
+            if (k == dim_) {
+                break;
+            }
+        }
+    }
+}
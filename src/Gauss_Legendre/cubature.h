@@ -0,0 +1,252 @@
+﻿/*! \file cubature.h
+    \brief Gauss-Legendre則のテンソル積と疎格子（Smolyak）による多次元積分クラスの宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _CUBATURE_H_
+#define _CUBATURE_H_
+
+#pragma once
+
+#include "Functional.h" // for myfunctional::has_batch
+#include "summation.h"  // for gausslegendre::accumulate, gausslegendre::ACCUMULATORS
+#include <algorithm>    // for std::min
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <type_traits>  // for std::false_type, std::integral_constant, std::true_type
+#include <vector>       // for std::vector
+
+namespace gausslegendre {
+    //! A enumeration.
+    /*!
+        多次元積分の格子の種類
+    */
+    enum class Grid : std::int32_t {
+        //! 各次元のGauss-Legendre則のテンソル積（点の数はlevelのdim乗）
+        TensorProduct,
+
+        //! Gauss-Legendre則を組み合わせたSmolyakの疎格子（全次数2 * level - 1の多項式まで厳密）
+        Smolyak
+    };
+
+    //! A class.
+    /*!
+        多次元の箱型領域[lower, upper]での積分を行うクラス
+        格子の点と重みは[-1, 1]^dimの上でコンストラクタで一度だけ求め、積分のたびに箱型領域へ写す
+        一次元のGauss-Legendre則はプロセス全体で共有されるテーブルを使う
+        写した座標と関数値の作業領域はコンストラクタで確保したものを使い回すので、積分のたびにメモリを確保しない
+        作業領域はオブジェクトが持つので、複数のスレッドから使うときはスレッドごとにコピーすること
+    */
+    class Cubature final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param dim 次元（1以上）
+            \param level Grid::TensorProductのときは各次元の分点、Grid::Smolyakのときは疎格子のレベル（1以上）
+            \param grid 格子の種類
+            \throw std::runtime_error 引数が正しくないか、格子の点が多すぎるとき
+        */
+        Cubature(std::uint32_t dim, std::uint32_t level, Grid grid = Grid::TensorProduct);
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            次元を返す
+            \return 次元
+        */
+        std::uint32_t dim() const
+        {
+            return dim_;
+        }
+
+        //! A public member function (template function).
+        /*!
+            箱型領域[lower, upper]で積分を実行する
+            点の座標はBLOCK個ずつまとめて箱型領域へ写す
+            被積分関数が配列をまとめて評価する形func(double const * x, double * y, std::size_t count)を持つときは、
+            写したcount個（BLOCK個以下）の点の座標（点ごとにdim個の座標が並ぶ）を一度に渡し、count個の関数値をyに受け取る
+            そうでないときは、点ごとにdim個の座標の配列を渡してdoubleの関数値を受け取る
+            重み付きの和はACCUMULATORS個の独立した累積変数に足し込む
+            \param func 被積分関数
+            \param lower 積分の下端の配列（dim要素）
+            \param upper 積分の上端の配列（dim要素）
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double integrate(FUNCTYPE const & func, double const * lower, double const * upper);
+
+        //! A public member function.
+        /*!
+            格子の点の数を返す
+            \return 格子の点の数
+        */
+        std::size_t points() const
+        {
+            return w_.size();
+        }
+
+    private:
+        //! A private member function (template function).
+        /*!
+            作業領域に写したcount個の点で、被積分関数を点ごとに評価する
+            \param func 被積分関数
+            \param count 点の数
+        */
+        template <typename FUNCTYPE>
+        void evaluate(FUNCTYPE const & func, std::size_t count, std::false_type);
+
+        //! A private member function (template function).
+        /*!
+            作業領域に写したcount個の点で、被積分関数を一度の呼び出しでまとめて評価する
+            \param func 被積分関数
+            \param count 点の数
+        */
+        template <typename FUNCTYPE>
+        void evaluate(FUNCTYPE const & func, std::size_t count, std::true_type);
+
+        //! A private member function.
+        /*!
+            各次元の分点ordersのGauss-Legendre則のテンソル積を、重みをscale倍して格子に加える
+            \param orders 各次元の分点（dim要素）
+            \param scale 重みに掛ける係数
+        */
+        void append(std::vector<std::uint32_t> const & orders, double scale);
+
+        //! A private member function.
+        /*!
+            Smolyakの疎格子を作る
+            \param level 疎格子のレベル
+        */
+        void smolyak(std::uint32_t level);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            まとめて箱型領域へ写す点の数
+        */
+        static std::size_t constexpr BLOCK = 256;
+
+        //! A private static member variable (constant).
+        /*!
+            格子の点の数の上限
+        */
+        static std::size_t constexpr MAXPOINTS = std::size_t(1) << 28;
+
+        //! A private member variable.
+        /*!
+            次元
+        */
+        std::uint32_t dim_;
+
+        //! A private member variable.
+        /*!
+            [-1, 1]^dimの上の格子の点（点ごとにdim個の座標が並ぶ）
+        */
+        std::vector<double> x_;
+
+        //! A private member variable.
+        /*!
+            格子の点の重み
+        */
+        std::vector<double> w_;
+
+        //! A private member variable.
+        /*!
+            箱型領域の中心（dim要素）
+        */
+        std::vector<double> xm_;
+
+        //! A private member variable.
+        /*!
+            箱型領域の各次元の幅の半分（dim要素）
+        */
+        std::vector<double> xr_;
+
+        //! A private member variable.
+        /*!
+            箱型領域へ写した点の座標の作業領域（BLOCK * dim要素）
+        */
+        std::vector<double> buf_;
+
+        //! A private member variable.
+        /*!
+            関数値の作業領域（BLOCK要素）
+        */
+        std::vector<double> y_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Cubature() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    template <typename FUNCTYPE>
+    inline double Cubature::integrate(FUNCTYPE const & func, double const * lower, double const * upper)
+    {
+        auto jacobian = 1.0;
+        for (auto k = 0U; k < dim_; k++) {
+            xm_[k] = 0.5 * (lower[k] + upper[k]);
+            xr_[k] = 0.5 * (upper[k] - lower[k]);
+            jacobian *= xr_[k];
+        }
+
+        std::array<double, ACCUMULATORS> sum = {};
+        auto const size = w_.size();
+        for (std::size_t first = 0; first < size; first += BLOCK) {
+            auto const count = std::min(BLOCK, size - first);
+
+            // 座標の写像は点の間に依存がないので、ベクトル化できる
+            auto const src = x_.data() + first * dim_;
+            for (std::size_t i = 0; i < count; i++) {
+                for (auto k = 0U; k < dim_; k++) {
+                    buf_[i * dim_ + k] = xm_[k] + xr_[k] * src[i * dim_ + k];
+                }
+            }
+
+            evaluate(func, count, std::integral_constant<bool, myfunctional::has_batch<FUNCTYPE>::value>());
+
+            // 点iはi % ACCUMULATORS番目の累積変数に足し込み、足し算の依存の連鎖を断つ
+            auto const w = w_.data() + first;
+            for (std::size_t i = 0; i < count; i += ACCUMULATORS) {
+                for (auto k = 0U; k < ACCUMULATORS && i + k < count; k++) {
+                    accumulate<Summation::Naive>(w[i + k], y_[i + k], sum[k], sum[k], std::false_type());
+                }
+            }
+        }
+
+        return simd::add_pairwise<ACCUMULATORS>(sum.data()) * jacobian;
+    }
+
+    template <typename FUNCTYPE>
+    inline void Cubature::evaluate(FUNCTYPE const & func, std::size_t count, std::false_type)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            y_[i] = func(buf_.data() + i * dim_);
+        }
+    }
+
+    template <typename FUNCTYPE>
+    inline void Cubature::evaluate(FUNCTYPE const & func, std::size_t count, std::true_type)
+    {
+        func(static_cast<double const *>(buf_.data()), y_.data(), count);
+    }
+}
+
+#endif  // _CUBATURE_H_
@@ -0,0 +1,111 @@
+﻿/*! \file gaussrule.cpp
+    \brief Gauss-Legendre以外のGauss型求積則（Jacobi, Laguerre, Hermite, Lobatto, Radau）で積分を行うクラスの実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "gaussrule.h"
+#include "integration.h"
+#include "ruleregistry.h"
+#include <stdexcept>    // for std::runtime_error
+
+namespace gausslegendre {
+    namespace {
+        //! A function.
+        /*!
+            alglibでGauss型求積則の節と重みのテーブルを計算する（Rule::Legendre以外）
+            \param rule Gauss型求積則の種類
+            \param n 節の数
+            \param alpha 重み関数の指数α
+            \param beta 重み関数の指数β
+            \return 節と重みのテーブル
+        */
+        std::shared_ptr<NodeTable const> generateTable(Rule rule, std::uint32_t n, double alpha, double beta)
+        {
+            alglib::ae_int_t info = 0;
+            alglib::real_1d_array x, w;
+            switch (rule) {
+            case Rule::Jacobi:
+                alglib::gqgenerategaussjacobi(n, alpha, beta, info, x, w);
+                break;
+
+            case Rule::Laguerre:
+                alglib::gqgenerategausslaguerre(n, alpha, info, x, w);
+                break;
+
+            case Rule::Hermite:
+                alglib::gqgenerategausshermite(n, info, x, w);
+                break;
+
+            case Rule::Lobatto:
+            case Rule::Radau:
+            {
+                // モニックなLegendre多項式の三項漸化式P_{k+1} = x P_k - k^2 / (4k^2 - 1) P_{k-1}の係数
+                alglib::real_1d_array a, b;
+                a.setlength(n);
+                b.setlength(n);
+                for (auto k = 0U; k < n; k++) {
+                    a[k] = 0.0;
+                    b[k] = k ? static_cast<double>(k) * k / (4.0 * k * k - 1.0) : 2.0;
+                }
+
+                if (rule == Rule::Lobatto) {
+                    alglib::gqgenerategausslobattorec(a, b, 2.0, -1.0, 1.0, n, info, x, w);
+                }
+                else {
+                    alglib::gqgenerategaussradaurec(a, b, 2.0, -1.0, n, info, x, w);
+                }
+                break;
+            }
+
+            default:
+                throw std::runtime_error("不明な求積則の種類");
+                break;
+            }
+
+            switch (info) {
+            case 1:
+                break;
+
+            default:
+                throw std::runtime_error("alglibで求積則の節と重みを求められなかった");
+                break;
+            }
+
+            auto const table = std::make_shared<NodeTable>(n);
+            for (auto i = 0U; i < n; i++) {
+                table->x()[i] = x[i];
+                table->w()[i] = w[i];
+            }
+
+            table->pad();
+
+            return table;
+        }
+    }
+
+    GaussRule::GaussRule(Rule rule, std::uint32_t n, double alpha, double beta, Kernel kernel, Summation summation, Execution execution)
+        : engine_(makeTable(rule, n, alpha, beta), n, kernel, summation, Storage::Full, execution),
+          exponent_(rule == Rule::Jacobi ? alpha + beta + 1.0 : rule == Rule::Laguerre ? alpha + 1.0 : 1.0),
+          rule_(rule)
+    {
+    }
+
+    std::shared_ptr<NodeTable const> GaussRule::makeTable(Rule rule, std::uint32_t n, double alpha, double beta)
+    {
+        if (rule == Rule::Legendre) {
+            return nodeTable(n, Storage::Full);
+        }
+
+        // 使わない指数はキーに含めない
+        if (rule != Rule::Jacobi) {
+            beta = 0.0;
+            if (rule != Rule::Laguerre) {
+                alpha = 0.0;
+            }
+        }
+
+        // テーブルは一度計算したら、Gauss-Legendreのテーブルと同じ登録簿でプロセス全体で共有する
+        // （alglibは固有値問題を解くので重いが、計算はロックの外で行う）
+        return ruleTable(rule, n, alpha, beta, generateTable);
+    }
+}
@@ -0,0 +1,243 @@
+﻿/*! \file gaussrule.h
+    \brief Gauss-Legendre以外のGauss型求積則（Jacobi, Laguerre, Hermite, Lobatto, Radau）で積分を行うクラスの宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _GAUSSRULE_H_
+#define _GAUSSRULE_H_
+
+#pragma once
+
+#include "Gauss_Legendre.h"
+#include <cmath>        // for std::pow
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <memory>       // for std::shared_ptr
+#include <stdexcept>    // for std::runtime_error
+
+namespace gausslegendre {
+    //! A enumeration.
+    /*!
+        Gauss型求積則の種類（重み関数と節の区間）
+    */
+    enum class Rule : std::int32_t {
+        //! 重み関数1、区間[-1, 1]
+        Legendre,
+
+        //! 重み関数(1 - x)^α (1 + x)^β、区間[-1, 1]
+        Jacobi,
+
+        //! 重み関数x^α exp(-x)、区間[0, ∞)
+        Laguerre,
+
+        //! 重み関数exp(-x^2)、区間(-∞, ∞)
+        Hermite,
+
+        //! 重み関数1、区間[-1, 1]、両端を節に含む
+        Lobatto,
+
+        //! 重み関数1、区間[-1, 1]、左端を節に含む
+        Radau
+    };
+
+    //! A class.
+    /*!
+        Gauss型求積則の節と重みのテーブルをGauss_Legendreと同じSIMDの積分カーネルで使うクラス
+        節x_iは一次変換shift + scale * x_iで積分区間に写され、重み付きの和にscale^pを掛けたものが積分値になる
+        pは重み関数の次数で決まる（Jacobiではα + β + 1、Laguerreではα + 1、それ以外では1）
+        Rule::Legendre以外の節と重みは、求積則の種類、節の数、α、βの組ごとに一度だけalglibで計算し、プロセス全体で共有する
+    */
+    class GaussRule final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param rule Gauss型求積則の種類
+            \param n 節の数（Rule::Lobattoでは3以上、Rule::Radauでは2以上）
+            \param alpha Rule::JacobiとRule::Laguerreの重み関数の指数α（-1より大きいこと）
+            \param beta Rule::Jacobiの重み関数の指数β（-1より大きいこと）
+            \param kernel 使用する積分カーネル（Kernel::Autoなら最良のものを自動で選ぶ）
+            \param summation 重み付きの和を求める方法
+            \param execution 一回の積分の実行方法
+            \throw std::runtime_error 節と重みを求められなかったとき
+        */
+        GaussRule(Rule rule, std::uint32_t n, double alpha = 0.0, double beta = 0.0, Kernel kernel = Kernel::Auto, Summation summation = Summation::Naive, Execution execution = Execution::Sequential);
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            有限の積分区間[x1, x2]で、重み関数付きの積分を実行する
+            Rule::Jacobiでは∫(x2 - t)^α (t - x1)^β f(t) dtを求める（x1 < x2であること）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+            \throw std::runtime_error Rule::LaguerreかRule::Hermiteのとき（qgaussaffineを使うこと）
+        */
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const;
+
+        //! A public member function (template function).
+        /*!
+            有限の積分区間[x1, x2]で、重み関数付きの積分を実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+            \throw std::runtime_error Rule::LaguerreかRule::Hermiteのとき（qgaussaffineを使うこと）
+        */
+        template <typename FUNCTYPE>
+        double qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const;
+
+        //! A public member function (template function).
+        /*!
+            節を一次変換t = shift + scale * xで写した積分を実行する
+            Rule::Laguerreでは∫_shift^∞ (t - shift)^α exp(-(t - shift) / scale) f(t) dtを、
+            Rule::Hermiteでは∫ exp(-((t - shift) / scale)^2) f(t) dtを求める
+            \param func 被積分関数
+            \param shift 一次変換の平行移動
+            \param scale 一次変換の拡大率（正であること）
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double qgaussaffine(myfunctional::Functional<FUNCTYPE> const & func, double shift, double scale) const;
+
+        //! A public member function (template function).
+        /*!
+            節を一次変換t = shift + scale * xで写した積分を実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \param shift 一次変換の平行移動
+            \param scale 一次変換の拡大率（正であること）
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double qgaussaffine(myfunctional::VectorFunctional<FUNCTYPE> const & func, double shift, double scale) const;
+
+        //! A public member function.
+        /*!
+            Gauss型求積則の種類を返す
+            \return Gauss型求積則の種類
+        */
+        Rule rule() const
+        {
+            return rule_;
+        }
+
+    private:
+        //! A private static member function.
+        /*!
+            Gauss型求積則の節と重みのテーブルを返す（計算済みならキャッシュから返す）
+            \param rule Gauss型求積則の種類
+            \param n 節の数
+            \param alpha 重み関数の指数α
+            \param beta 重み関数の指数β
+            \return 節と重みのテーブル
+        */
+        static std::shared_ptr<NodeTable const> makeTable(Rule rule, std::uint32_t n, double alpha, double beta);
+
+        //! A private member function (template function).
+        /*!
+            有限の積分区間[x1, x2]で積分を実行する（qgaussの実装）
+            \param func 被積分関数
+            \param x1 積分の下端
+            \param x2 積分の上端
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        double qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const;
+
+        //! A private member function (template function).
+        /*!
+            節を一次変換で写した積分を実行する（qgaussaffineの実装）
+            \param func 被積分関数
+            \param shift 一次変換の平行移動
+            \param scale 一次変換の拡大率
+            \return 積分値
+        */
+        template <typename FUNCTIONAL>
+        double qgaussaffineimpl(FUNCTIONAL const & func, double shift, double scale) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            節と重みのテーブルと積分カーネル
+        */
+        Gauss_Legendre engine_;
+
+        //! A private member variable.
+        /*!
+            積分値に掛けるscaleの指数
+        */
+        double exponent_;
+
+        //! A private member variable.
+        /*!
+            Gauss型求積則の種類
+        */
+        Rule rule_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        GaussRule() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    template <typename FUNCTYPE>
+    inline double GaussRule::qgauss(myfunctional::Functional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTYPE>
+    inline double GaussRule::qgauss(myfunctional::VectorFunctional<FUNCTYPE> const & func, double x1, double x2) const
+    {
+        return qgaussimpl(func, x1, x2);
+    }
+
+    template <typename FUNCTYPE>
+    inline double GaussRule::qgaussaffine(myfunctional::Functional<FUNCTYPE> const & func, double shift, double scale) const
+    {
+        return qgaussaffineimpl(func, shift, scale);
+    }
+
+    template <typename FUNCTYPE>
+    inline double GaussRule::qgaussaffine(myfunctional::VectorFunctional<FUNCTYPE> const & func, double shift, double scale) const
+    {
+        return qgaussaffineimpl(func, shift, scale);
+    }
+
+    template <typename FUNCTIONAL>
+    inline double GaussRule::qgaussimpl(FUNCTIONAL const & func, double x1, double x2) const
+    {
+        if (rule_ == Rule::Laguerre || rule_ == Rule::Hermite) {
+            throw std::runtime_error("無限区間の求積則は、qgaussaffineで積分区間を指定しなければならない");
+        }
+
+        return qgaussaffineimpl(func, 0.5 * (x1 + x2), 0.5 * (x2 - x1));
+    }
+
+    template <typename FUNCTIONAL>
+    inline double GaussRule::qgaussaffineimpl(FUNCTIONAL const & func, double shift, double scale) const
+    {
+        return engine_.qgaussaffine(func, shift, scale) * (exponent_ == 1.0 ? scale : std::pow(scale, exponent_));
+    }
+}
+
+#endif  // _GAUSSRULE_H_
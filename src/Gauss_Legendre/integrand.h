@@ -0,0 +1,157 @@
+﻿/*! \file integrand.h
+    \brief 動的に読み込むモジュールなどから渡される、型消去された被積分関数のクラスの宣言と実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _INTEGRAND_H_
+#define _INTEGRAND_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+
+namespace myfunctional {
+    //! A class.
+    /*!
+        型消去された被積分関数の基底クラス
+        仮想関数の呼び出しは節のまとまり（Gauss_Legendre::qgaussでは256個）ごとに一度だけ行われるので、
+        間接呼び出しのコストは節の数で割られる
+    */
+    class Integrand
+    {
+    public:
+        // #region コンストラクタ・デストラクタ
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        virtual ~Integrand() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (pure virtual function).
+        /*!
+            n個のxの値について、関数f(x)の値をまとめて求める
+            Execution::Parallelで使うときは、複数のスレッドから同時に呼び出されてもよいように実装すること
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        virtual void evaluate(double const * x, double * y, std::size_t n) const = 0;
+
+        // #endregion メンバ関数
+    };
+
+    //! A class.
+    /*!
+        C言語の関数ポインタとコンテキストで表された被積分関数
+        C++のABIに依存しないので、動的に読み込むモジュールが公開する関数をそのまま使える
+    */
+    class FunctionIntegrand final : public Integrand
+    {
+    public:
+        //! A typedef.
+        /*!
+            n個のxの値について、関数f(x)の値をまとめて求める関数の型
+        */
+        typedef void (*FunctionType)(void * context, double const * x, double * y, std::size_t n);
+
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param func 関数ポインタ
+            \param context 関数ポインタに渡すコンテキスト
+        */
+        FunctionIntegrand(FunctionType func, void * context) : context_(context), func_(func) {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (virtual function).
+        /*!
+            n個のxの値について、関数f(x)の値をまとめて求める
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void evaluate(double const * x, double * y, std::size_t n) const override
+        {
+            func_(context_, x, y, n);
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            関数ポインタに渡すコンテキスト
+        */
+        void * context_;
+
+        //! A private member variable.
+        /*!
+            関数ポインタ
+        */
+        FunctionType func_;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        Integrandへの参照を、配列をまとめて評価する形の関数オブジェクトにするクラス
+        make_functionalに渡せば、Integrandを他の積分クラスでも使える
+    */
+    class IntegrandRef final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param integrand 型消去された被積分関数（このオブジェクトより長く生存すること）
+        */
+        explicit IntegrandRef(Integrand const & integrand) : integrand_(&integrand) {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            n個のxの値について、関数f(x)の値をまとめて求める
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * x, double * y, std::size_t n) const
+        {
+            integrand_->evaluate(x, y, n);
+        }
+
+        // #endregion メンバ関数
+
+    private:
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            型消去された被積分関数
+        */
+        Integrand const * integrand_;
+
+        // #endregion メンバ変数
+    };
+}
+
+#endif  // _INTEGRAND_H_
@@ -0,0 +1,198 @@
+﻿/*! \file kernel.cpp
+    \brief 積分カーネル（使用する命令セット）の判定を行う関数の実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "kernel.h"
+
+#if defined(_MSC_VER)
+    #include <array>        // for std::array
+    #include <immintrin.h>  // for _xgetbv
+    #include <intrin.h>     // for __cpuid, __cpuidex
+#endif
+
+namespace gausslegendre {
+    namespace {
+        //! A function.
+        /*!
+            AVX命令が使用可能かどうかをチェックする
+            \return AVX命令が使用可能ならtrue、使用不可能ならfalse
+        */
+        bool availableAVX()
+        {
+#if defined(_MSC_VER)
+            std::array<std::int32_t, 4> cpuInfo = { 0 };
+            __cpuid(cpuInfo.data(), 1);
+
+            auto const osUsesXSAVE_XRSTORE = cpuInfo[2] & (1 << 27) || false;
+            auto const cpuAVXSuport = cpuInfo[2] & (1 << 28) || false;
+
+            if (osUsesXSAVE_XRSTORE && cpuAVXSuport)
+            {
+                // Check if the OS will save the YMM registers
+                auto const xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+                return (xcrFeatureMask & 0x6) == 0x6;
+            }
+
+            return false;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            // libgccの判定はOSがYMMレジスタを保存するかどうかも確認している
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx") != 0;
+#else
+            return false;
+#endif
+        }
+
+        //! A function.
+        /*!
+            AVX2命令とFMA命令が使用可能かどうかをチェックする
+            \return AVX2命令とFMA命令が使用可能ならtrue、使用不可能ならfalse
+        */
+        bool availableAVX2()
+        {
+#if defined(_MSC_VER)
+            if (!availableAVX()) {
+                return false;
+            }
+
+            std::array<std::int32_t, 4> cpuInfo = { 0 };
+            __cpuid(cpuInfo.data(), 1);
+            auto const cpuFMASupport = cpuInfo[2] & (1 << 12) || false;
+
+            __cpuidex(cpuInfo.data(), 7, 0);
+            auto const cpuAVX2Support = cpuInfo[1] & (1 << 5) || false;
+
+            return cpuFMASupport && cpuAVX2Support;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+        }
+
+        //! A function.
+        /*!
+            AVX-512F命令が使用可能かどうかをチェックする
+            \return AVX-512F命令が使用可能ならtrue、使用不可能ならfalse
+        */
+        bool availableAVX512()
+        {
+#if defined(_MSC_VER)
+            if (!availableAVX()) {
+                return false;
+            }
+
+            std::array<std::int32_t, 4> cpuInfo = { 0 };
+            __cpuidex(cpuInfo.data(), 7, 0);
+
+            auto const cpuAVX512FSupport = cpuInfo[1] & (1 << 16) || false;
+            if (cpuAVX512FSupport)
+            {
+                // Check if the OS will save the opmask and ZMM registers
+                auto const xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+                return (xcrFeatureMask & 0xE6) == 0xE6;
+            }
+
+            return false;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") != 0;
+#else
+            return false;
+#endif
+        }
+
+        //! A function.
+        /*!
+            SSE2命令が使用可能かどうかをチェックする
+            \return SSE2命令が使用可能ならtrue、使用不可能ならfalse
+        */
+        bool availableSSE2()
+        {
+#if defined(_M_X64) || defined(__x86_64__)
+            // x64ではSSE2は必ず使用可能
+            return true;
+#elif defined(_MSC_VER)
+            std::array<std::int32_t, 4> cpuInfo = { 0 };
+            __cpuid(cpuInfo.data(), 1);
+            return cpuInfo[3] & (1 << 26) || false;
+#elif defined(__GNUC__) && defined(__i386__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") != 0;
+#else
+            return false;
+#endif
+        }
+    }
+
+    bool availableKernel(Kernel kernel)
+    {
+        switch (kernel) {
+        case Kernel::Auto:
+        case Kernel::Scalar:
+            return true;
+
+        case Kernel::SSE2:
+            return availableSSE2();
+
+        case Kernel::AVX:
+            return availableAVX();
+
+        case Kernel::AVX2:
+            return availableAVX2();
+
+        case Kernel::AVX512:
+            return availableAVX512();
+
+        default:
+            return false;
+        }
+    }
+
+    Kernel bestKernel()
+    {
+        if (availableAVX512()) {
+            return Kernel::AVX512;
+        }
+        else if (availableAVX2()) {
+            return Kernel::AVX2;
+        }
+        else if (availableAVX()) {
+            return Kernel::AVX;
+        }
+        else if (availableSSE2()) {
+            return Kernel::SSE2;
+        }
+        else {
+            return Kernel::Scalar;
+        }
+    }
+
+    char const * kernelName(Kernel kernel)
+    {
+        switch (kernel) {
+        case Kernel::Auto:
+            return "Auto";
+
+        case Kernel::Scalar:
+            return "Scalar";
+
+        case Kernel::SSE2:
+            return "SSE2";
+
+        case Kernel::AVX:
+            return "AVX";
+
+        case Kernel::AVX2:
+            return "AVX2";
+
+        case Kernel::AVX512:
+            return "AVX-512";
+
+        default:
+            return "Unknown";
+        }
+    }
+}
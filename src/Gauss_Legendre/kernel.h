@@ -0,0 +1,166 @@
+﻿/*! \file kernel.h
+    \brief 積分カーネルの設定（使用する命令セット、和の取り方、実行方法、精度、節と重みの格納方法）の列挙と、
+    命令セットの判定を行う関数の宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _KERNEL_H_
+#define _KERNEL_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+
+namespace gausslegendre {
+    //! A enumeration.
+    /*!
+        積分カーネル（使用する命令セット）
+    */
+    enum class Kernel : std::int32_t {
+        //! CPUが対応している最良のカーネルを自動で選ぶ
+        Auto,
+
+        //! SIMDを使用しない
+        Scalar,
+
+        //! SSE2（倍精度2要素）
+        SSE2,
+
+        //! AVX（倍精度4要素）
+        AVX,
+
+        //! AVX2とFMA（倍精度4要素）
+        AVX2,
+
+        //! AVX-512F（倍精度8要素、FMA）
+        AVX512
+    };
+
+    //! A enumeration.
+    /*!
+        積分カーネルが重み付きの和を求める方法
+    */
+    enum class Summation : std::int32_t {
+        //! 複数の累積変数で単純に足し合わせる
+        Naive,
+
+        //! 複数の累積変数で、丸め誤差を補償しながら足し合わせる（TwoSumによるNeumaier法と同等）
+        Compensated,
+
+        //! 重みと関数値の積の丸め誤差もTwoProdで拾い、和と誤差の組（double-double）で足し合わせる
+        //! 結果は倍精度の2倍の精度で計算してから丸めたものと同程度に正確になる（Ogita-Rump-OishiのDot2）
+        //! ただしStorage::Symmetricでは、対になる二つの節の関数値の和を足し込む前に一度丸める
+        DoubleDouble,
+
+        //! 節を決まった数の累積変数に決まった順序で割り当て、FMAを使わずに足し合わせる
+        //! 結果はカーネル、実行方法、スレッド数によらずビット単位で一致する
+        //! 積和の融合は、積分カーネルが被積分関数ごとコンパイラに禁止させる（Clangでは-ffp-contract=offでコンパイルすること）
+        //! （被積分関数がスカラーでもSIMDベクトルでも同じ値を返すこと）
+        Reproducible
+    };
+
+    //! A enumeration.
+    /*!
+        一回の積分の実行方法
+    */
+    enum class Execution : std::int32_t {
+        //! 一つのスレッドで実行する
+        Sequential,
+
+        //! 節を一定の大きさのチャンクに分け、OpenMPで並列に実行する
+        //! チャンクの部分和はチャンクの順に足し合わせるので、結果はスレッド数によらない
+        Parallel
+    };
+
+    //! A enumeration.
+    /*!
+        単精度の積分カーネルの精度
+    */
+    enum class Precision : std::int32_t {
+        //! 被積分関数の評価も、重み付きの和も単精度で行う（SIMDベクトルの要素数が倍精度の2倍になる）
+        Single,
+
+        //! 被積分関数の評価は単精度で、重み付きの和は倍精度（倍精度の重み）で行う
+        Mixed
+    };
+
+    //! A enumeration.
+    /*!
+        Gauss-Legendreの節と重みの格納方法
+    */
+    enum class Storage : std::int32_t {
+        //! すべての節と重みを格納する
+        Full,
+
+        //! 節がx = 0について対称であることを利用し、非負の節とその重みだけを格納する
+        //! 積分カーネルはf(xm + xr * x) + f(xm - xr * x)を一つの重みで足し込む
+        Symmetric
+    };
+
+    //! A global variable (constant).
+    /*!
+        Kernel::Autoを除いた積分カーネルの数
+    */
+    std::uint32_t constexpr KERNELS = 5;
+
+    //! A function.
+    /*!
+        積分カーネルと、それ以外の設定の組の番号から、積分カーネルの表の添字を求める
+        積分の各クラスは、コンストラクタでこの添字を一度だけ求め、積分のたびには表を引くだけにする
+        \param kernel 積分カーネル（Kernel::Autoは不可）
+        \param variant 積分カーネル以外の設定の組の番号
+        \return 積分カーネルの表の添字
+    */
+    constexpr std::uint32_t dispatchIndex(Kernel kernel, std::uint32_t variant)
+    {
+        return variant * KERNELS + static_cast<std::uint32_t>(kernel) - static_cast<std::uint32_t>(Kernel::Scalar);
+    }
+
+    //! A function.
+    /*!
+        積分カーネルの表の添字から、積分カーネルを求める（dispatchIndexの逆）
+        \param index 積分カーネルの表の添字
+        \return 積分カーネル
+    */
+    constexpr Kernel dispatchKernel(std::size_t index)
+    {
+        return static_cast<Kernel>(index % KERNELS + static_cast<std::size_t>(Kernel::Scalar));
+    }
+
+    //! A function.
+    /*!
+        積分カーネルの表の添字から、積分カーネル以外の設定の組の番号を求める（dispatchIndexの逆）
+        \param index 積分カーネルの表の添字
+        \return 積分カーネル以外の設定の組の番号
+    */
+    constexpr std::uint32_t dispatchVariant(std::size_t index)
+    {
+        return static_cast<std::uint32_t>(index / KERNELS);
+    }
+
+    //! A function.
+    /*!
+        指定したカーネルがこのCPUとOSで使用可能かどうかを返す
+        \param kernel 調べるカーネル
+        \return 使用可能ならtrue、使用不可能ならfalse
+    */
+    bool availableKernel(Kernel kernel);
+
+    //! A function.
+    /*!
+        このCPUとOSで使用可能な最良のカーネルを返す
+        \return 最良のカーネル
+    */
+    Kernel bestKernel();
+
+    //! A function.
+    /*!
+        カーネルの名前を返す
+        \param kernel カーネル
+        \return カーネルの名前
+    */
+    char const * kernelName(Kernel kernel);
+}
+
+#endif  // _KERNEL_H_
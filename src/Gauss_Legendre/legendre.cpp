@@ -0,0 +1,229 @@
+﻿/*! \file legendre.cpp
+    \brief Gauss-Legendreの節と重みをO(n)で求める関数の実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "legendre.h"
+#include <algorithm>    // for std::min
+#include <array>        // for std::array
+#include <cmath>        // for std::acos, std::cos, std::exp, std::fabs, std::sin, std::sqrt
+
+namespace gausslegendre {
+    namespace {
+        //! A global variable (constant).
+        /*!
+            両端からそれぞれ何個の節を漸化式で求めるか
+        */
+        static auto constexpr BOUNDARY = 10U;
+
+        //! A global variable (constant).
+        /*!
+            Newton法の最大反復回数
+        */
+        static auto constexpr MAXITER = 10U;
+
+        //! A global variable (constant).
+        /*!
+            Stieltjesの漸近展開の最大項数
+        */
+        static auto constexpr MAXTERMS = 60U;
+
+        //! A global variable (constant).
+        /*!
+            円周率
+        */
+        static auto constexpr PI = 3.14159265358979323846;
+
+        //! A global variable (constant).
+        /*!
+            Bessel関数J_0の零点（小さい方からBOUNDARY個）
+        */
+        static std::array<double, BOUNDARY> constexpr BESSELJ0ZEROS = {
+            2.404825557695773, 5.520078110286311, 8.653727912911013, 11.79153443901428, 14.93091770848779,
+            18.07106396791092, 21.21163662987926, 24.35247153074930, 27.49347913204025, 30.63460646843198
+        };
+
+        //! A function.
+        /*!
+            Stieltjesの漸近展開の係数C_n = (4 / π)Π_{j=1}^{n} j / (j + 1/2)を求める
+            z = n + 3/4として、log(Γ(z + 1/4) / Γ(z + 3/4))の漸近展開を用いる
+            \param n Legendre多項式の次数
+            \return C_nの値
+        */
+        double stieltjesConstant(std::uint32_t n)
+        {
+            auto const z = static_cast<double>(n) + 0.75;
+            auto const iz2 = 1.0 / (z * z);
+            auto const series = iz2 * (-1.0 / 64.0 + iz2 * (5.0 / 2048.0 + iz2 * (-61.0 / 49152.0 + iz2 * (1385.0 / 1048576.0))));
+
+            return 2.0 / std::sqrt(PI * z) * std::exp(series);
+        }
+
+        //! A function.
+        /*!
+            Stieltjesの漸近展開でP_n(cos(θ))とdP_n(cos(θ)) / dθを求める
+            \param n Legendre多項式の次数
+            \param cn 係数C_n
+            \param theta θの値
+            \param dp dP_n(cos(θ)) / dθの値
+            \return P_n(cos(θ))の値
+        */
+        double stieltjes(std::uint32_t n, double cn, double theta, double & dp)
+        {
+            auto const s = std::sin(theta);
+            auto const c = std::cos(theta);
+            auto const cot = c / s;
+            auto const nu = static_cast<double>(n) + 0.5;
+
+            // α_m = (n + m + 1/2)θ - (m + 1/2)π / 2は、mが1増えるごとにθ - π / 2だけ回転する
+            auto const alpha = nu * theta - 0.25 * PI;
+            auto ca = std::cos(alpha);
+            auto sa = std::sin(alpha);
+
+            auto const r2s = 0.5 / s;
+            auto h = 1.0;
+            auto p = 0.0;
+            dp = 0.0;
+            for (auto m = 0U; m < MAXTERMS; m++) {
+                auto const mh = static_cast<double>(m) + 0.5;
+                p += h * ca;
+                dp -= h * ((nu + static_cast<double>(m)) * sa + mh * cot * ca);
+
+                auto const next = h * mh * mh / ((static_cast<double>(m) + 1.0) * (nu + static_cast<double>(m) + 1.0)) * r2s;
+                if (next < 1.0E-17 || next > h) {
+                    break;
+                }
+
+                auto const ca2 = ca * s + sa * c;
+                sa = sa * s - ca * c;
+                ca = ca2;
+                h = next;
+            }
+
+            auto const scale = cn / std::sqrt(2.0 * s);
+            dp *= scale;
+
+            return p * scale;
+        }
+
+        //! A function.
+        /*!
+            u = 1 - cos(θ)についての漸化式で、BOUNDARY個のθにおけるP_n(cos(θ))とdP_n(cos(θ)) / dθを同時に求める
+            P_kとD_k = P_k - P_{k-1}を更新するので、x = cos(θ)の丸め誤差の影響を受けない
+            \param n Legendre多項式の次数
+            \param theta θの値
+            \param p P_n(cos(θ))の値
+            \param dp dP_n(cos(θ)) / dθの値
+        */
+        void recurrence(std::uint32_t n, std::array<double, BOUNDARY> const & theta, std::array<double, BOUNDARY> & p, std::array<double, BOUNDARY> & dp)
+        {
+            std::array<double, BOUNDARY> u, d;
+            for (auto j = 0U; j < BOUNDARY; j++) {
+                auto const sh = std::sin(0.5 * theta[j]);
+                u[j] = 2.0 * sh * sh;
+                p[j] = 1.0 - u[j];
+                d[j] = -u[j];
+            }
+
+            for (auto k = 1U; k < n; k++) {
+                // k / (k + 1) = 1 - r, (2k + 1) / (k + 1) = 2 - r
+                auto const r = 1.0 / static_cast<double>(k + 1);
+                auto const a = 1.0 - r;
+                auto const b = 2.0 - r;
+                for (auto j = 0U; j < BOUNDARY; j++) {
+                    d[j] = a * d[j] - b * u[j] * p[j];
+                    p[j] += d[j];
+                }
+            }
+
+            for (auto j = 0U; j < BOUNDARY; j++) {
+                dp[j] = static_cast<double>(n) * (d[j] - u[j] * p[j]) / std::sin(theta[j]);
+            }
+        }
+    }
+
+    void legendreNodes(std::uint32_t n, double * x, double * w)
+    {
+        auto const nu = static_cast<double>(n) + 0.5;
+        auto const half = (n + 1) / 2;
+        auto const nboundary = std::min(BOUNDARY, n / 2);
+
+        // 節を大きい方からk = 1, 2, ...と数えると、θ_kはおよそ(k - 1/4)π / (n + 1/2)である
+        auto const store = [n, x, w](std::uint32_t k, double theta, double dp) {
+            auto const xk = std::cos(theta);
+            auto const wk = 2.0 / (dp * dp);
+            x[n - k] = xk;
+            w[n - k] = wk;
+            x[k - 1] = -xk;
+            w[k - 1] = wk;
+        };
+
+        // 端付近の節（初期値はJ_0の零点j_kを用いたθ_k ≒ j_k / sqrt((n + 1/2)^2 + 1/12)）
+        std::array<double, BOUNDARY> theta, dp;
+        for (auto j = 0U; j < nboundary; j++) {
+            theta[j] = BESSELJ0ZEROS[j] / std::sqrt(nu * nu + 1.0 / 12.0);
+        }
+
+        // 使わない要素は、漸化式を一定の長さのループで回すためのダミー
+        for (auto j = nboundary; j < BOUNDARY; j++) {
+            theta[j] = 0.5 * PI;
+        }
+
+        std::array<double, BOUNDARY> p;
+        for (auto iter = 0U; iter < MAXITER; iter++) {
+            recurrence(n, theta, p, dp);
+
+            auto converged = true;
+            for (auto j = 0U; j < nboundary; j++) {
+                auto const dtheta = p[j] / dp[j];
+                theta[j] -= dtheta;
+                converged = converged && std::fabs(dtheta) <= 1.0E-15 * theta[j];
+            }
+
+            if (converged) {
+                break;
+            }
+        }
+
+        for (auto j = 0U; j < nboundary; j++) {
+            store(j + 1, theta[j], dp[j]);
+        }
+
+        // それ以外の節
+        auto const cn = stieltjesConstant(n);
+        auto const n2 = static_cast<double>(n) * static_cast<double>(n);
+        for (auto k = nboundary + 1; k <= n / 2; k++) {
+            // Tricomiの漸近式による初期値
+            auto const phi = PI * (static_cast<double>(k) - 0.25) / nu;
+            auto const sphi = std::sin(phi);
+            auto t = std::acos((1.0 - (static_cast<double>(n) - 1.0) / (8.0 * n2 * static_cast<double>(n)) - (39.0 - 28.0 / (sphi * sphi)) / (384.0 * n2 * n2)) * std::cos(phi));
+            auto d = 0.0;
+            for (auto iter = 0U; iter < MAXITER; iter++) {
+                auto const dtheta = stieltjes(n, cn, t, d) / d;
+                t -= dtheta;
+                if (std::fabs(dtheta) <= 1.0E-15 * t) {
+                    // 根ではd^2P/dθ^2 ≒ 0なので、最後の更新の前に求めたdP/dθをそのまま使ってよい
+                    break;
+                }
+            }
+
+            store(k, t, d);
+        }
+
+        if (n & 0x01) {
+            // 中央の節（x = 0）
+            // P_n(0) = 0なので、Newton法は不要
+            std::array<double, BOUNDARY> center, pcenter, dcenter;
+            center.fill(0.5 * PI);
+            if (n > 2 * BOUNDARY) {
+                stieltjes(n, cn, center[0], dcenter[0]);
+            }
+            else {
+                recurrence(n, center, pcenter, dcenter);
+            }
+
+            x[half - 1] = 0.0;
+            w[half - 1] = 2.0 / (dcenter[0] * dcenter[0]);
+        }
+    }
+}
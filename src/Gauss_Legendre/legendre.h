@@ -0,0 +1,27 @@
+﻿/*! \file legendre.h
+    \brief Gauss-Legendreの節と重みをO(n)で求める関数の宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _LEGENDRE_H_
+#define _LEGENDRE_H_
+
+#pragma once
+
+#include <cstdint>  // for std::uint32_t
+
+namespace gausslegendre {
+    //! A function.
+    /*!
+        n点のGauss-Legendreの節と重みを求める
+        節をx = cos(θ)と表し、θについてのNewton法でLegendre多項式の根を求める
+        両端付近の節は漸化式で、それ以外の節はStieltjesの漸近展開でP_n(cos(θ))を評価するので、
+        計算量もメモリ使用量もO(n)である
+        \param n Gauss-Legendreの分点（1以上）
+        \param x 節を格納する配列（n要素、昇順に格納される）
+        \param w 重みを格納する配列（n要素）
+    */
+    void legendreNodes(std::uint32_t n, double * x, double * w);
+}
+
+#endif  // _LEGENDRE_H_
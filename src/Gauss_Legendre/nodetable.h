@@ -0,0 +1,253 @@
+﻿/*! \file nodetable.h
+    \brief Gauss-Legendreの節と重みを格納するクラスの宣言と実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _NODETABLE_H_
+#define _NODETABLE_H_
+
+#pragma once
+
+#include <algorithm>                        // for std::fill_n
+#include <cstddef>                          // for std::size_t
+#include <cstdint>                          // for std::uint32_t
+#include <memory>                           // for std::shared_ptr
+#include <new>                              // for std::bad_alloc
+#include <utility>                          // for std::exchange, std::move
+#include <boost/align/aligned_alloc.hpp>    // for boost::alignment::aligned_alloc, boost::alignment::aligned_free
+
+namespace gausslegendre {
+    //! A class.
+    /*!
+        Gauss-Legendreの節と重みを、64バイト境界に揃えた一つのバッファに
+        structure-of-arrays形式（節の配列の後に重みの配列）で格納するクラス
+        節の配列と重みの配列は、それぞれALIGNMENTバイトの倍数に切り上げた長さを持つので、
+        重みの配列の先頭も64バイト境界に揃う
+        切り上げた部分の節は最後の節で、重みは0で埋められる
+        バッファは自分で確保するか、外部のメモリ（ファイルをマップした領域など）を参照する
+    */
+    class NodeTable final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（空のテーブル）
+        */
+        NodeTable() = default;
+
+        //! A constructor.
+        /*!
+            size個の節と重みを格納するテーブルを確保する（値は0で初期化される）
+            \param size 節と重みの数
+        */
+        explicit NodeTable(std::uint32_t size)
+            : size_(size),
+              stride_(strideOf(size))
+        {
+            auto const count = 2 * static_cast<std::size_t>(stride_);
+            auto const p = static_cast<double *>(boost::alignment::aligned_alloc(ALIGNMENT, (count ? count : 1) * sizeof(double)));
+            if (!p) {
+                throw std::bad_alloc();
+            }
+
+            std::fill_n(p, count, 0.0);
+            data_ = p;
+            owner_ = std::shared_ptr<void>(p, boost::alignment::aligned_free);
+        }
+
+        //! A constructor.
+        /*!
+            外部のメモリを参照するテーブルを作る（コピーはしない）
+            \param size 節と重みの数
+            \param data 節と重みのバッファ（2 * strideOf(size)要素、ALIGNMENTバイト境界に揃っていること）
+            \param owner dataの領域を所有するオブジェクト（テーブルが生きている間、領域を保持する）
+        */
+        NodeTable(std::uint32_t size, double * data, std::shared_ptr<void> owner)
+            : size_(size),
+              stride_(strideOf(size)),
+              data_(data),
+              owner_(std::move(owner))
+        {
+        }
+
+        //! A move constructor.
+        /*!
+            ムーブコンストラクタ
+            ムーブ元は空のテーブルになる
+            \param other ムーブ元のオブジェクト
+        */
+        NodeTable(NodeTable && other) noexcept
+            : size_(std::exchange(other.size_, 0U)),
+              stride_(std::exchange(other.stride_, 0U)),
+              data_(std::exchange(other.data_, nullptr)),
+              owner_(std::move(other.owner_))
+        {
+        }
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        NodeTable(NodeTable const &) = delete;
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function.
+        /*!
+            operator=()の宣言（ムーブ代入演算子）
+            ムーブ元は空のテーブルになる
+            \param other ムーブ元のオブジェクト
+            \return このオブジェクト
+        */
+        NodeTable & operator=(NodeTable && other) noexcept
+        {
+            size_ = std::exchange(other.size_, 0U);
+            stride_ = std::exchange(other.stride_, 0U);
+            data_ = std::exchange(other.data_, nullptr);
+            owner_ = std::move(other.owner_);
+
+            return *this;
+        }
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト
+            \return コピー元のオブジェクト
+        */
+        NodeTable & operator=(NodeTable const &) = delete;
+
+        //! A public member function.
+        /*!
+            切り上げた部分を埋める
+            節と重みを全て書き込んだ後に一度だけ呼ぶ
+        */
+        void pad()
+        {
+            for (auto i = size_; i < stride_; i++) {
+                data_[i] = size_ ? data_[size_ - 1] : 0.0;
+                data_[stride_ + i] = 0.0;
+            }
+        }
+
+        //! A public member function.
+        /*!
+            格納している節と重みの数を返す
+            \return 格納している節と重みの数
+        */
+        std::uint32_t size() const
+        {
+            return size_;
+        }
+
+        //! A public member function.
+        /*!
+            節の配列と重みの配列の長さを返す
+            \return 節の配列と重みの配列の長さ（size()をLANESの倍数に切り上げたもの）
+        */
+        std::uint32_t stride() const
+        {
+            return stride_;
+        }
+
+        //! A public static member function.
+        /*!
+            size個の節と重みを格納するときの、節の配列と重みの配列の長さを返す
+            \param size 節と重みの数
+            \return sizeをLANESの倍数に切り上げたもの
+        */
+        static constexpr std::uint32_t strideOf(std::uint32_t size)
+        {
+            return (size + LANES - 1) / LANES * LANES;
+        }
+
+        //! A public member function.
+        /*!
+            節の配列の先頭を返す
+            \return 節の配列の先頭（64バイト境界に揃っている）
+        */
+        double * x()
+        {
+            return data_;
+        }
+
+        //! A public member function.
+        /*!
+            節の配列の先頭を返す
+            \return 節の配列の先頭（64バイト境界に揃っている）
+        */
+        double const * x() const
+        {
+            return data_;
+        }
+
+        //! A public member function.
+        /*!
+            重みの配列の先頭を返す
+            \return 重みの配列の先頭（64バイト境界に揃っている）
+        */
+        double * w()
+        {
+            return data_ + stride_;
+        }
+
+        //! A public member function.
+        /*!
+            重みの配列の先頭を返す
+            \return 重みの配列の先頭（64バイト境界に揃っている）
+        */
+        double const * w() const
+        {
+            return data_ + stride_;
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant).
+        /*!
+            バッファのalignment（AVX-512のベクトル一本分）
+        */
+        static std::uint32_t constexpr ALIGNMENT = 64;
+
+        //! A public static member variable (constant).
+        /*!
+            ALIGNMENTバイトに収まるdoubleの数
+        */
+        static std::uint32_t constexpr LANES = ALIGNMENT / sizeof(double);
+
+    private:
+        //! A private member variable.
+        /*!
+            格納している節と重みの数
+        */
+        std::uint32_t size_ = 0;
+
+        //! A private member variable.
+        /*!
+            節の配列と重みの配列の長さ（size_をLANESの倍数に切り上げたもの）
+        */
+        std::uint32_t stride_ = 0;
+
+        //! A private member variable.
+        /*!
+            節と重みを格納するバッファの先頭（alignmentが揃っている）
+        */
+        double * data_ = nullptr;
+
+        //! A private member variable.
+        /*!
+            バッファの領域を所有するオブジェクト
+        */
+        std::shared_ptr<void> owner_;
+
+        // #endregion メンバ変数
+    };
+}
+
+#endif  // _NODETABLE_H_
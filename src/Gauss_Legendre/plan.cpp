@@ -0,0 +1,46 @@
+﻿/*! \file plan.cpp
+    \brief 積分区間を固定して、写像済みの節と重みを保持する積分プランクラスの実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "plan.h"
+
+namespace gausslegendre {
+    Plan::Plan(NodeTable const & table, Storage storage, Kernel kernel, Summation summation, double x1, double x2)
+        : dispatch_(dispatchIndex(kernel, static_cast<std::uint32_t>(summation)))
+    {
+        auto const xm = 0.5 * (x1 + x2);
+        auto const xr = 0.5 * (x2 - x1);
+        auto const x = table.x();
+        auto const w = table.w();
+        auto const size = table.size();
+
+        if (storage == Storage::Symmetric) {
+            // 非負の側の節xm + xr * x_iと、対になる節xm - xr * x_iを並べて格納する
+            auto const mapped = std::make_shared<NodeTable>(2 * size);
+            auto const xt = mapped->x();
+            auto const wt = mapped->w();
+            for (auto i = 0U; i < size; i++) {
+                auto const d = x[i] * xr;
+                xt[2 * i] = xm + d;
+                xt[2 * i + 1] = xm - d;
+                wt[2 * i] = wt[2 * i + 1] = w[i] * xr;
+            }
+
+            mapped->pad();
+            table_ = mapped;
+        }
+        else {
+            auto const mapped = std::make_shared<NodeTable>(size);
+            auto const xt = mapped->x();
+            auto const wt = mapped->w();
+            for (auto i = 0U; i < size; i++) {
+                xt[i] = x[i] * xr + xm;
+                wt[i] = w[i] * xr;
+            }
+
+            mapped->pad();
+            table_ = mapped;
+        }
+    }
+}
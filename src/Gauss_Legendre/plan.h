@@ -0,0 +1,454 @@
+﻿/*! \file plan.h
+    \brief 積分区間を固定して、写像済みの節と重みを保持する積分プランクラスの宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _PLAN_H_
+#define _PLAN_H_
+
+#pragma once
+
+#include "Functional.h"
+#include "kernel.h"
+#include "nodetable.h"
+#include "simdvec.h"    // for simd::F64vec8, simd::F64vec4, simd::F64vec2
+#include "summation.h"
+#include <array>        // for std::array
+#include <cstdint>      // for std::uint32_t
+#include <memory>       // for std::shared_ptr
+#include <type_traits>  // for std::integral_constant
+#include <utility>      // for std::index_sequence, std::make_index_sequence
+
+namespace gausslegendre {
+    //! A class.
+    /*!
+        積分区間[x1, x2]を固定したGauss-Legendre積分のプラン
+        区間に写した節xm + xr * x_iと、xr倍した重みxr * w_iをALIGNMENTバイト境界に揃えて保持するので、
+        一回の積分は重みと関数値の内積だけになる
+        Storage::Symmetricのテーブルから作ったときも、写した節は両側とも格納する
+        一回の積分は常に一つのスレッドで実行する（Execution::Parallelは使わない）
+        プランは同じ区間の積分を何度も行うためのものなので、並列化するなら複数の積分を別々のスレッドで実行する
+    */
+    class Plan final
+    {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            節と重みのテーブルを積分区間[x1, x2]に写したプランを作る（通常はGauss_Legendre::plan()から呼び出す）
+            \param table 節と重みのテーブル
+            \param storage 節と重みの格納方法
+            \param kernel 使用する積分カーネル（Kernel::Autoは不可）
+            \param summation 重み付きの和を求める方法
+            \param x1 積分の下端
+            \param x2 積分の上端
+        */
+        Plan(NodeTable const & table, Storage storage, Kernel kernel, Summation summation, double x1, double x2);
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public member function (template function).
+        /*!
+            プランの積分区間で積分を実行する
+            \param func 被積分関数
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double integrate(myfunctional::Functional<FUNCTYPE> const & func) const;
+
+        //! A public member function (template function).
+        /*!
+            プランの積分区間で積分を実行する
+            被積分関数はSIMDベクトル単位でまとめて評価される
+            \param func 被積分関数（simd::F64vec8, simd::F64vec4, simd::F64vec2, doubleを引数に取れるもの）
+            \return 積分値
+        */
+        template <typename FUNCTYPE>
+        double integrate(myfunctional::VectorFunctional<FUNCTYPE> const & func) const;
+
+        //! A public member function.
+        /*!
+            区間に写した節の配列を返す
+            \return 区間に写した節の配列（size()要素）
+        */
+        double const * nodes() const
+        {
+            return table_->x();
+        }
+
+        //! A public member function.
+        /*!
+            区間に写した節の数を返す
+            \return 区間に写した節の数
+        */
+        std::uint32_t size() const
+        {
+            return table_->size();
+        }
+
+        //! A public member function.
+        /*!
+            xr倍した重みの配列を返す
+            \return xr倍した重みの配列（size()要素）
+        */
+        double const * weights() const
+        {
+            return table_->w();
+        }
+
+    private:
+        //! A private template alias.
+        /*!
+            重みと関数値の内積を求める関数（dotkernel）へのポインタ
+        */
+        template <typename FUNCTIONAL>
+        using DotKernel = double (Plan::*)(FUNCTIONAL const &) const;
+
+        //! A private static member function (template function).
+        /*!
+            積分カーネルの表の添字ごとに、dotkernelの実体へのポインタを並べた表を作る
+            \return dotkernelの実体へのポインタの表
+        */
+        template <typename FUNCTIONAL, std::size_t... I>
+        static constexpr std::array<DotKernel<FUNCTIONAL>, sizeof...(I)> dottable(std::index_sequence<I...>);
+
+        //! A private member function (template function).
+        /*!
+            AVX命令を使って重みと関数値の内積を求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, typename FUNCTIONAL>
+        SIMD_TARGET("avx") double dotavx(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX2命令とFMAを使って重みと関数値の内積を求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, typename FUNCTIONAL>
+        SIMD_TARGET("avx2,fma") double dotavx2(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            AVX-512F命令とFMAを使って重みと関数値の内積を求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") double dotavx512(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            dispatch_に従って、重みと関数値の内積を求める積分カーネルを呼び出す（integrateの実装）
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename FUNCTIONAL>
+        double dotimpl(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            KERNELに従って積分カーネルを呼び出す
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, Kernel KERNEL, typename FUNCTIONAL>
+        double dotkernel(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの内積を、AVX命令を使って求める（Kernel::AVXとKernel::AVX2で共通、FMAは使わない）
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("avx") SIMD_PRECISE double dotreproavx(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの内積を、AVX-512F命令を使って求める（FMAは使わない）
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("avx512f") SIMD_PRECISE double dotreproavx512(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの内積を、SIMDを使わずに求める
+            節iはi % REPROLANES番目の累積変数に節の順に足し込み、FMAは使わない
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename FUNCTIONAL>
+        SIMD_PRECISE double dotreproscalar(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの内積を、SIMDベクトルの型VECを使って、dotreproscalarと同じ順序で求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename VEC, typename FUNCTIONAL>
+        SIMD_FORCEINLINE double dotreprosimd(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            Summation::Reproducibleの内積を、SSE2命令を使って求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename FUNCTIONAL>
+        SIMD_TARGET("sse2") SIMD_PRECISE double dotreprosse2(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDを使わずに重みと関数値の内積を求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, typename FUNCTIONAL>
+        double dotscalar(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            SIMDベクトルの型VECを使って重みと関数値の内積を求める（各積分カーネルの共通部分）
+            端数の節は、テーブルの埋め草（最後の節と重み0）をそのまま読む
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <typename VEC, bool FMA, Summation SUMMATION, typename FUNCTIONAL>
+        SIMD_FORCEINLINE double dotsimd(FUNCTIONAL const & func) const;
+
+        //! A private member function (template function).
+        /*!
+            SSE2命令を使って重みと関数値の内積を求める
+            \param func 被積分関数
+            \return 重みと関数値の内積
+        */
+        template <Summation SUMMATION, typename FUNCTIONAL>
+        SIMD_TARGET("sse2") double dotsse2(FUNCTIONAL const & func) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            積分カーネルの表の大きさ（重み付きの和を求める方法の数 × 積分カーネルの数）
+        */
+        static std::uint32_t constexpr DISPATCHES = 4 * KERNELS;
+
+        //! A private member variable.
+        /*!
+            積分カーネルの表の添字（コンストラクタで、積分カーネルと和の取り方から一度だけ求める）
+        */
+        std::uint32_t dispatch_;
+
+        //! A private member variable.
+        /*!
+            区間に写した節と、xr倍した重み（コピーしたプランの間で共有される）
+        */
+        std::shared_ptr<NodeTable const> table_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Plan() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    template <typename FUNCTYPE>
+    inline double Plan::integrate(myfunctional::Functional<FUNCTYPE> const & func) const
+    {
+        return dotimpl(func);
+    }
+
+    template <typename FUNCTYPE>
+    inline double Plan::integrate(myfunctional::VectorFunctional<FUNCTYPE> const & func) const
+    {
+        return dotimpl(func);
+    }
+
+    template <typename FUNCTIONAL, std::size_t... I>
+    inline constexpr std::array<Plan::DotKernel<FUNCTIONAL>, sizeof...(I)> Plan::dottable(std::index_sequence<I...>)
+    {
+        return { { &Plan::dotkernel<static_cast<Summation>(dispatchVariant(I)), dispatchKernel(I), FUNCTIONAL>... } };
+    }
+
+    template <Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotavx(FUNCTIONAL const & func) const
+    {
+        return dotsimd<simd::F64vec4, false, SUMMATION>(func);
+    }
+
+    template <Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotavx2(FUNCTIONAL const & func) const
+    {
+        return dotsimd<simd::F64vec4, true, SUMMATION>(func);
+    }
+
+    template <Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotavx512(FUNCTIONAL const & func) const
+    {
+        return dotsimd<simd::F64vec8, true, SUMMATION>(func);
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Plan::dotimpl(FUNCTIONAL const & func) const
+    {
+        static constexpr auto table = dottable<FUNCTIONAL>(std::make_index_sequence<DISPATCHES>());
+        return (this->*table[dispatch_])(func);
+    }
+
+    template <Summation SUMMATION, Kernel KERNEL, typename FUNCTIONAL>
+    inline double Plan::dotkernel(FUNCTIONAL const & func) const
+    {
+        // Summation::Reproducibleでは、積和を融合させない専用の関数を使う
+        if (SUMMATION == Summation::Reproducible) {
+            switch (KERNEL) {
+            case Kernel::AVX512:
+                return dotreproavx512(func);
+
+            case Kernel::AVX2:
+            case Kernel::AVX:
+                return dotreproavx(func);
+
+            case Kernel::SSE2:
+                return dotreprosse2(func);
+
+            default:
+                return dotreproscalar(func);
+            }
+        }
+
+        switch (KERNEL) {
+        case Kernel::AVX512:
+            return dotavx512<SUMMATION>(func);
+
+        case Kernel::AVX2:
+            return dotavx2<SUMMATION>(func);
+
+        case Kernel::AVX:
+            return dotavx<SUMMATION>(func);
+
+        case Kernel::SSE2:
+            return dotsse2<SUMMATION>(func);
+
+        default:
+            return dotscalar<SUMMATION>(func);
+        }
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Plan::dotreproavx(FUNCTIONAL const & func) const
+    {
+        return dotreprosimd<simd::F64vec4>(func);
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Plan::dotreproavx512(FUNCTIONAL const & func) const
+    {
+        return dotreprosimd<simd::F64vec8>(func);
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Plan::dotreproscalar(FUNCTIONAL const & func) const
+    {
+        auto const x = table_->x();
+
+        // 端数の節は、SIMDベクトルの幅によらずstride()まで埋め草（重み0）を読む
+        return reproducibleSum(table_->w(), 0U, table_->stride(), [&](std::uint32_t i) {
+            return func(x[i]);
+        });
+    }
+
+    template <typename VEC, typename FUNCTIONAL>
+    inline double Plan::dotreprosimd(FUNCTIONAL const & func) const
+    {
+        auto const x = table_->x();
+        return reproducibleSumSimd<VEC>(table_->w(), 0U, table_->stride(), [&](std::uint32_t j) {
+            return func(VEC::load(&x[j]));
+        });
+    }
+
+    template <typename FUNCTIONAL>
+    inline double Plan::dotreprosse2(FUNCTIONAL const & func) const
+    {
+        return dotreprosimd<simd::F64vec2>(func);
+    }
+
+    template <Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotscalar(FUNCTIONAL const & func) const
+    {
+        auto const x = table_->x();
+        auto const w = table_->w();
+        auto const size = table_->size();
+
+        auto sum = 0.0, comp = 0.0;
+        for (auto i = 0U; i < size; i++) {
+            accumulate<SUMMATION>(w[i], func(x[i]), sum, comp, std::false_type());
+        }
+
+        return SUMMATION != Summation::Naive ? sum + comp : sum;
+    }
+
+    template <typename VEC, bool FMA, Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotsimd(FUNCTIONAL const & func) const
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        std::integral_constant<bool, FMA> const usefma;
+
+        auto const x = table_->x();
+        auto const w = table_->w();
+        auto const size = table_->size();
+        std::array<VEC, ACCUMULATORS> sum, comp;
+        sum.fill(VEC(0.0));
+        comp.fill(VEC(0.0));
+
+        auto i = 0U;
+        for (; i + W * ACCUMULATORS <= size; i += W * ACCUMULATORS) {
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                accumulate<SUMMATION>(VEC::load(&w[i + k * W]), VEC(func(VEC::load(&x[i + k * W]))), sum[k], comp[k], usefma);
+            }
+        }
+
+        for (; i < size; i += W) {
+            accumulate<SUMMATION>(VEC::load(&w[i]), VEC(func(VEC::load(&x[i]))), sum[0], comp[0], usefma);
+        }
+
+        if (SUMMATION != Summation::Naive) {
+            auto hi = 0.0, lo = 0.0;
+            for (auto k = 0U; k < ACCUMULATORS; k++) {
+                for (auto j = 0U; j < W; j++) {
+                    auto e = 0.0;
+                    hi = simd::twosum(hi, sum[k][j], e);
+                    lo += e + comp[k][j];
+                }
+            }
+
+            return hi + lo;
+        }
+
+        return simd::add_horizontal((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    }
+
+    template <Summation SUMMATION, typename FUNCTIONAL>
+    inline double Plan::dotsse2(FUNCTIONAL const & func) const
+    {
+        return dotsimd<simd::F64vec2, false, SUMMATION>(func);
+    }
+}
+
+#endif  // _PLAN_H_
@@ -0,0 +1,258 @@
+﻿/*! \file rulefile.cpp
+    \brief Gauss-Legendreの節と重みのテーブルをファイルに保存し、メモリマップで読み込む関数の実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "rulefile.h"
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for std::size_t
+#include <cstdio>       // for std::remove, std::rename
+#include <cstring>      // for std::memcmp, std::memcpy
+#include <fstream>      // for std::ofstream
+#include <stdexcept>    // for std::runtime_error
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <Windows.h>    // for CreateFileA, CreateFileMappingA, MapViewOfFile, UnmapViewOfFile, MoveFileExA
+#else
+    #include <cerrno>       // for errno, EEXIST, ENOENT
+    #include <fcntl.h>      // for open
+    #include <sys/mman.h>   // for mmap, munmap
+    #include <sys/stat.h>   // for fstat
+    #include <unistd.h>     // for close, getpid
+#endif
+
+namespace gausslegendre {
+    namespace {
+        //! A global variable (constant).
+        /*!
+            ファイルの識別子
+        */
+        static char const MAGIC[8] = { 'G', 'L', 'R', 'U', 'L', 'E', '\0', '\0' };
+
+        //! A global variable (constant).
+        /*!
+            ファイル形式のバージョン
+        */
+        static auto constexpr VERSION = 1U;
+
+        //! A global variable (constant).
+        /*!
+            バイトオーダーの確認用の値
+        */
+        static auto constexpr BYTEORDER = 0x01020304U;
+
+        //! A function.
+        /*!
+            節の配列と重みの配列のチェックサム（64ビット単位のFNV-1a）を求める
+            \param data 節と重みのバッファ
+            \param count バッファの要素数
+            \return チェックサム
+        */
+        std::uint64_t checksum(double const * data, std::size_t count)
+        {
+            auto hash = 14695981039346656037ULL;
+            for (std::size_t i = 0; i < count; i++) {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                hash ^= word;
+                hash *= 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+        //! A function.
+        /*!
+            ファイル全体を読み取り専用でメモリにマップする
+            \param path ファイルのパス
+            \param length マップした領域のバイト数
+            \return マップした領域（ファイルが存在しなければnullptr）
+        */
+        std::shared_ptr<void> mapFile(std::string const & path, std::size_t & length)
+        {
+#if defined(_WIN32)
+            auto const file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                auto const error = ::GetLastError();
+                if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) {
+                    return nullptr;
+                }
+
+                throw std::runtime_error(path + "を開けない");
+            }
+
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(RuleFileHeader))) {
+                ::CloseHandle(file);
+                throw std::runtime_error(path + "はGauss-Legendreのテーブルではない");
+            }
+
+            auto const mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            ::CloseHandle(file);
+            if (!mapping) {
+                throw std::runtime_error(path + "をマップできない");
+            }
+
+            auto const addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            ::CloseHandle(mapping);
+            if (!addr) {
+                throw std::runtime_error(path + "をマップできない");
+            }
+
+            length = static_cast<std::size_t>(size.QuadPart);
+            return std::shared_ptr<void>(addr, [](void * p) { ::UnmapViewOfFile(p); });
+#else
+            auto const fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                if (errno == ENOENT) {
+                    return nullptr;
+                }
+
+                throw std::runtime_error(path + "を開けない");
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(RuleFileHeader))) {
+                ::close(fd);
+                throw std::runtime_error(path + "はGauss-Legendreのテーブルではない");
+            }
+
+            auto const size = static_cast<std::size_t>(st.st_size);
+            auto const addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED) {
+                throw std::runtime_error(path + "をマップできない");
+            }
+
+            length = size;
+            return std::shared_ptr<void>(addr, [size](void * p) { ::munmap(p, size); });
+#endif
+        }
+
+        //! A function.
+        /*!
+            pathと同じディレクトリに、他と重ならない名前の空の一時ファイルを作る
+            \param path 最終的に書き込むファイルのパス
+            
+eturn 作った一時ファイルのパス
+        */
+        std::string createTemporary(std::string const & path)
+        {
+            static std::atomic<std::uint32_t> counter(0);
+
+            for (auto retry = 0; retry < 100; retry++) {
+#if defined(_WIN32)
+                auto const temporary = path + ".tmp." + std::to_string(::GetCurrentProcessId()) + "." + std::to_string(counter++);
+                auto const file = ::CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (file != INVALID_HANDLE_VALUE) {
+                    ::CloseHandle(file);
+                    return temporary;
+                }
+
+                if (::GetLastError() != ERROR_FILE_EXISTS) {
+                    break;
+                }
+#else
+                auto const temporary = path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+                auto const fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+                if (fd >= 0) {
+                    ::close(fd);
+                    return temporary;
+                }
+
+                if (errno != EEXIST) {
+                    break;
+                }
+#endif
+            }
+
+            throw std::runtime_error(path + "の一時ファイルを作れない");
+        }
+
+        //! A function.
+        /*!
+            一時ファイルの名前を変えて、pathのファイルと置き換える
+            pathをマップしている他のオブジェクトやプロセスは、置き換える前のファイルを参照し続ける
+            \param temporary 一時ファイルのパス
+            \param path 置き換えるファイルのパス
+            
+eturn 置き換えられたかどうか
+        */
+        bool replaceFile(std::string const & temporary, std::string const & path)
+        {
+#if defined(_WIN32)
+            return ::MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+            return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+        }
+    }
+
+    std::shared_ptr<NodeTable const> loadNodeTable(std::string const & path, std::uint32_t n, Storage storage, bool verify)
+    {
+        std::size_t length = 0;
+        auto const mapped = mapFile(path, length);
+        if (!mapped) {
+            return nullptr;
+        }
+
+        auto const & header = *static_cast<RuleFileHeader const *>(mapped.get());
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION ||
+            header.byteorder != BYTEORDER ||
+            header.precision != sizeof(double)) {
+            throw std::runtime_error(path + "はGauss-Legendreのテーブルではないか、形式が異なる");
+        }
+
+        auto const size = storage == Storage::Symmetric ? (n + 1) / 2 : n;
+        if (header.n != n || header.storage != static_cast<std::uint32_t>(storage) || header.size != size) {
+            throw std::runtime_error(path + "の分点または格納方法が一致しない");
+        }
+
+        auto const count = 2 * static_cast<std::size_t>(NodeTable::strideOf(size));
+        if (header.stride != NodeTable::strideOf(size) || length != sizeof(RuleFileHeader) + count * sizeof(double)) {
+            throw std::runtime_error(path + "の大きさが正しくない");
+        }
+
+        // ヘッダの大きさはNodeTable::ALIGNMENTなので、データの先頭もalignmentが揃っている
+        auto const data = reinterpret_cast<double const *>(static_cast<char const *>(mapped.get()) + sizeof(RuleFileHeader));
+        if (verify && checksum(data, count) != header.checksum) {
+            throw std::runtime_error(path + "のチェックサムが一致しない");
+        }
+
+        // テーブルはconstとしてしか使わないので、読み取り専用の領域を参照してよい
+        return std::make_shared<NodeTable const>(size, const_cast<double *>(data), mapped);
+    }
+
+    void saveNodeTable(std::string const & path, NodeTable const & table, std::uint32_t n, Storage storage)
+    {
+        auto const count = 2 * static_cast<std::size_t>(table.stride());
+
+        RuleFileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteorder = BYTEORDER;
+        header.precision = sizeof(double);
+        header.n = n;
+        header.storage = static_cast<std::uint32_t>(storage);
+        header.size = table.size();
+        header.stride = table.stride();
+        header.checksum = checksum(table.x(), count);
+
+        // pathをその場で書き換えると、pathをマップしているオブジェクト（自分自身を含む）が
+        // 切り詰められた領域を読むことになるので、一時ファイルに書いてから名前を変えて置き換える
+        auto const temporary = createTemporary(path);
+
+        // 節の配列と重みの配列は、一つのバッファに連続して並んでいる
+        std::ofstream ofs(temporary, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<char const *>(table.x()), static_cast<std::streamsize>(count * sizeof(double)));
+        ofs.flush();
+        ofs.close();
+        if (!ofs || !replaceFile(temporary, path)) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error(path + "に書き込めない");
+        }
+    }
+}
@@ -0,0 +1,121 @@
+﻿/*! \file rulefile.h
+    \brief Gauss-Legendreの節と重みのテーブルをファイルに保存し、メモリマップで読み込む関数の宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _RULEFILE_H_
+#define _RULEFILE_H_
+
+#pragma once
+
+#include "kernel.h"
+#include "nodetable.h"
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <memory>       // for std::shared_ptr
+#include <string>       // for std::string
+
+namespace gausslegendre {
+    //! A struct.
+    /*!
+        節と重みのテーブルのファイルのヘッダ（64バイト）
+        ヘッダの直後に、NodeTableのバッファ（節の配列と重みの配列）がそのまま続く
+    */
+    struct RuleFileHeader final {
+        //! A public member variable.
+        /*!
+            ファイルの識別子（"GLRULE"）
+        */
+        char magic[8];
+
+        //! A public member variable.
+        /*!
+            ファイル形式のバージョン
+        */
+        std::uint32_t version;
+
+        //! A public member variable.
+        /*!
+            バイトオーダーの確認用の値（0x01020304）
+        */
+        std::uint32_t byteorder;
+
+        //! A public member variable.
+        /*!
+            節と重みの精度（1要素のバイト数）
+        */
+        std::uint32_t precision;
+
+        //! A public member variable.
+        /*!
+            Gauss-Legendreの分点
+        */
+        std::uint32_t n;
+
+        //! A public member variable.
+        /*!
+            節と重みの格納方法
+        */
+        std::uint32_t storage;
+
+        //! A public member variable.
+        /*!
+            格納している節と重みの数
+        */
+        std::uint32_t size;
+
+        //! A public member variable.
+        /*!
+            節の配列と重みの配列の長さ
+        */
+        std::uint32_t stride;
+
+        //! A public member variable.
+        /*!
+            予約領域（0）
+        */
+        std::uint32_t reserved0;
+
+        //! A public member variable.
+        /*!
+            節の配列と重みの配列のチェックサム（64ビット単位のFNV-1a）
+        */
+        std::uint64_t checksum;
+
+        //! A public member variable.
+        /*!
+            予約領域（0）
+        */
+        std::uint64_t reserved[2];
+    };
+
+    static_assert(sizeof(RuleFileHeader) == NodeTable::ALIGNMENT, "RuleFileHeader must keep the table aligned");
+
+    //! A function.
+    /*!
+        節と重みのテーブルをファイルからメモリマップで読み込む
+        テーブルはマップした領域を直接参照するので、コピーは行わない
+        ヘッダは常に確かめるが、チェックサムはverifyがtrueのときだけ確かめる
+        （チェックサムを求めるとファイル全体を読むことになり、必要なページだけを読み込むというメモリマップの利点が失われる）
+        \param path ファイルのパス
+        \param n Gauss-Legendreの分点
+        \param storage 節と重みの格納方法
+        \param verify 節と重みのチェックサムを確かめるかどうか
+        \return 節と重みのテーブル（ファイルが存在しなければnullptr）
+        \throw std::runtime_error ファイルが壊れているか、nやstorageが一致しないとき
+    */
+    std::shared_ptr<NodeTable const> loadNodeTable(std::string const & path, std::uint32_t n, Storage storage, bool verify = false);
+
+    //! A function.
+    /*!
+        節と重みのテーブルをファイルに保存する
+        同じディレクトリの一時ファイルに書いてから名前を変えて置き換えるので、pathをマップしているテーブルは元の内容のまま使える
+        \param path ファイルのパス
+        \param table 節と重みのテーブル
+        \param n Gauss-Legendreの分点
+        \param storage 節と重みの格納方法
+        \throw std::runtime_error 書き込みに失敗したとき
+    */
+    void saveNodeTable(std::string const & path, NodeTable const & table, std::uint32_t n, Storage storage);
+}
+
+#endif  // _RULEFILE_H_
@@ -0,0 +1,295 @@
+﻿/*! \file ruleregistry.cpp
+    \brief Gauss-Legendreと、それ以外のGauss型求積則の節と重みのテーブルをプロセス全体で共有するための関数の実装
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "ruleregistry.h"
+#include "gaussrule.h"
+#include "legendre.h"
+#include <array>        // for std::array
+#include <atomic>       // for std::atomic
+#include <cstring>      // for std::memcpy
+#include <mutex>        // for std::mutex, std::lock_guard
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+namespace gausslegendre {
+    namespace {
+        //! A global variable (constant).
+        /*!
+            登録済みのテーブルを分類するバケットの数
+        */
+        static auto constexpr BUCKETS = 64U;
+
+        //! A function.
+        /*!
+            倍精度浮動小数点数のビット列を返す
+            \param value 値
+            \return valueのビット列
+        */
+        std::uint64_t bitsOf(double value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        //! A struct.
+        /*!
+            登録済みのテーブルのキー
+            αとβはビット列で比べるので、NaNでも一致を判定できる
+        */
+        struct Key final {
+            //! A public member variable.
+            /*!
+                Gauss型求積則の種類
+            */
+            Rule rule;
+
+            //! A public member variable.
+            /*!
+                節の数
+            */
+            std::uint32_t n;
+
+            //! A public member variable.
+            /*!
+                節と重みの格納方法
+            */
+            Storage storage;
+
+            //! A public member variable.
+            /*!
+                重み関数の指数αのビット列
+            */
+            std::uint64_t alpha;
+
+            //! A public member variable.
+            /*!
+                重み関数の指数βのビット列
+            */
+            std::uint64_t beta;
+
+            //! A public member function.
+            /*!
+                operator==の宣言と実装
+                \param rhs 比べるキー
+                \return 全ての成分が等しければtrue
+            */
+            bool operator==(Key const & rhs) const
+            {
+                return rule == rhs.rule && n == rhs.n && storage == rhs.storage && alpha == rhs.alpha && beta == rhs.beta;
+            }
+        };
+
+        //! A struct.
+        /*!
+            登録済みのテーブルを格納する連結リストの要素
+            一度公開された要素は変更されない
+        */
+        struct Entry final {
+            //! A public member variable (constant).
+            /*!
+                テーブルのキー
+            */
+            Key const key;
+
+            //! A public member variable (constant).
+            /*!
+                節と重みのテーブル
+            */
+            std::shared_ptr<NodeTable const> const table;
+
+            //! A public member variable (constant).
+            /*!
+                同じバケットの次の要素
+            */
+            Entry const * const next;
+        };
+
+        //! A class.
+        /*!
+            登録済みのテーブルを保持するクラス
+            検索はバケットの先頭をacquireで読むだけで、ロックは追加のときだけ取る
+            テーブルの計算はロックの外で行い、ロックの中では登録済みかどうかを確かめて連結リストにつなぐだけにする
+        */
+        class Registry final {
+        public:
+            // #region コンストラクタ・デストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+            */
+            Registry()
+            {
+                for (auto & head : heads_) {
+                    head.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            //! A destructor.
+            /*!
+                デストラクタ
+                テーブルは、まだ使っているGauss_Legendreのオブジェクトがあればそちらで生き続ける
+            */
+            ~Registry()
+            {
+                for (auto & head : heads_) {
+                    auto entry = head.load(std::memory_order_relaxed);
+                    while (entry) {
+                        auto const next = entry->next;
+                        delete entry;
+                        entry = next;
+                    }
+                }
+            }
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region メンバ関数
+
+            //! A public member function (template function).
+            /*!
+                キーkeyに対応するテーブルを返す（未登録なら計算して登録する）
+                \param key テーブルのキー
+                \param generate 引数を取らず、テーブルを計算して返す関数
+                \return 節と重みのテーブル
+            */
+            template <typename GENERATOR>
+            std::shared_ptr<NodeTable const> get(Key const & key, GENERATOR const & generate)
+            {
+                auto & head = heads_[key.n % BUCKETS];
+                if (auto const entry = find(head.load(std::memory_order_acquire), key)) {
+                    return entry->table;
+                }
+
+                // 計算は重いことがある（alglibは固有値問題を解く）ので、ロックを取る前に済ませる
+                auto table = generate();
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                // 計算している間に、他のスレッドが登録したかもしれない
+                auto const first = head.load(std::memory_order_relaxed);
+                if (auto const entry = find(first, key)) {
+                    return entry->table;
+                }
+
+                auto const entry = new Entry{ key, std::move(table), first };
+                head.store(entry, std::memory_order_release);
+
+                return entry->table;
+            }
+
+            //! A public static member function.
+            /*!
+                Gauss-Legendreの節と重みを計算してテーブルを作る
+                \param n Gauss-Legendreの分点
+                \param storage 節と重みの格納方法
+                \return 節と重みのテーブル
+            */
+            static std::shared_ptr<NodeTable const> makeTable(std::uint32_t n, Storage storage);
+
+        private:
+            //! A private static member function.
+            /*!
+                連結リストからテーブルを探す
+                \param entry 連結リストの先頭
+                \param key テーブルのキー
+                \return 見つかった要素（見つからなければnullptr）
+            */
+            static Entry const * find(Entry const * entry, Key const & key)
+            {
+                for (; entry; entry = entry->next) {
+                    if (entry->key == key) {
+                        return entry;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            // #endregion メンバ関数
+
+            // #region メンバ変数
+
+            //! A private member variable.
+            /*!
+                各バケットの連結リストの先頭
+            */
+            std::array<std::atomic<Entry const *>, BUCKETS> heads_;
+
+            //! A private member variable.
+            /*!
+                テーブルを追加するときのロック
+            */
+            std::mutex mutex_;
+
+            // #endregion メンバ変数
+        };
+
+        std::shared_ptr<NodeTable const> Registry::makeTable(std::uint32_t n, Storage storage)
+        {
+            if (!n) {
+                throw std::runtime_error("Gauss-Legendreの分点は1以上でなければならない");
+            }
+
+            // 小さな分点でも、alglib（固有値問題）よりlegendreNodes()の方が正確である
+            // （N = 1～64の重みの相対誤差は、alglibが最大で5e-13程度、legendreNodes()が1e-14以下）
+            std::vector<double> x(n), w(n);
+            legendreNodes(n, x.data(), w.data());
+
+            auto const nstored = storage == Storage::Symmetric ? (n + 1) / 2 : n;
+            auto const table = std::make_shared<NodeTable>(nstored);
+            auto const xt = table->x();
+            auto const wt = table->w();
+            if (storage == Storage::Symmetric) {
+                // 節は昇順に並んでいるので、対になる節と重みを平均して非負の側だけを格納する
+                for (auto i = 0U; i < nstored; i++) {
+                    auto const pos = n - nstored + i;
+                    auto const neg = nstored - 1 - i;
+                    xt[i] = 0.5 * (x[pos] - x[neg]);
+                    wt[i] = 0.5 * (w[pos] + w[neg]);
+                }
+
+                if (n & 0x01) {
+                    // 中央の節（x = 0）はf(xm)が二回足されるので、重みを半分にする
+                    wt[0] *= 0.5;
+                }
+            }
+            else {
+                for (auto i = 0U; i < n; i++) {
+                    xt[i] = x[i];
+                    wt[i] = w[i];
+                }
+            }
+
+            table->pad();
+
+            return table;
+        }
+
+        //! A function.
+        /*!
+            プロセス全体で共有する登録簿を返す
+            \return 登録簿
+        */
+        Registry & registry()
+        {
+            static Registry registry;
+
+            return registry;
+        }
+    }
+
+    std::shared_ptr<NodeTable const> nodeTable(std::uint32_t n, Storage storage)
+    {
+        return registry().get(Key{ Rule::Legendre, n, storage, 0, 0 }, [n, storage] { return Registry::makeTable(n, storage); });
+    }
+
+    std::shared_ptr<NodeTable const> ruleTable(Rule rule, std::uint32_t n, double alpha, double beta, RuleGenerator generate)
+    {
+        return registry().get(Key{ rule, n, Storage::Full, bitsOf(alpha), bitsOf(beta) }, [=] { return generate(rule, n, alpha, beta); });
+    }
+}
@@ -0,0 +1,58 @@
+﻿/*! \file ruleregistry.h
+    \brief Gauss-Legendreと、それ以外のGauss型求積則の節と重みのテーブルをプロセス全体で共有するための関数の宣言
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _RULEREGISTRY_H_
+#define _RULEREGISTRY_H_
+
+#pragma once
+
+#include "kernel.h"
+#include "nodetable.h"
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <memory>       // for std::shared_ptr
+
+namespace gausslegendre {
+    //! A enumeration (forward declaration).
+    /*!
+        Gauss型求積則の種類（gaussrule.hで定義する）
+    */
+    enum class Rule : std::int32_t;
+
+    //! A typedef.
+    /*!
+        Gauss型求積則の節と重みのテーブルを計算する関数の型
+        引数は求積則の種類、節の数、重み関数の指数αとβ
+    */
+    using RuleGenerator = std::shared_ptr<NodeTable const> (*)(Rule, std::uint32_t, double, double);
+
+    //! A function.
+    /*!
+        分点nと格納方法storageに対応する節と重みのテーブルを返す
+        テーブルは初めて要求されたときに一度だけ計算され、以後はプロセス全体で共有される
+        登録済みのテーブルの検索はロックを取らないので、複数のスレッドから同時に呼び出してよい
+        \param n Gauss-Legendreの分点
+        \param storage 節と重みの格納方法
+        \return 節と重みのテーブル（変更不可）
+    */
+    std::shared_ptr<NodeTable const> nodeTable(std::uint32_t n, Storage storage);
+
+    //! A function.
+    /*!
+        求積則の種類rule、節の数n、重み関数の指数αとβの組に対応する節と重みのテーブルを返す
+        テーブルはnodeTableと同じ登録簿に格納され、初めて要求されたときにgenerateで計算される
+        計算はロックの外で行うので、他のスレッドの検索や、別の組の計算を待たせない
+        （同じ組を複数のスレッドが同時に計算したときは、最初に登録されたテーブルを全員が使う）
+        αとβはビット列で比べる
+        \param rule Gauss型求積則の種類
+        \param n 節の数
+        \param alpha 重み関数の指数α
+        \param beta 重み関数の指数β
+        \param generate テーブルを計算する関数
+        \return 節と重みのテーブル（変更不可）
+    */
+    std::shared_ptr<NodeTable const> ruleTable(Rule rule, std::uint32_t n, double alpha, double beta, RuleGenerator generate);
+}
+
+#endif  // _RULEREGISTRY_H_
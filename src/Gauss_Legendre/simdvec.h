@@ -0,0 +1,1630 @@
+﻿/*! \file simdvec.h
+    \brief コンパイラに依存しないSIMDベクトルクラス（倍精度と単精度）の宣言と実装
+    MSVCではintrinsicsを、GCCとClangではベクトル拡張を用いて実装する
+    GCCでsqrtをベクトル化させるには-fno-math-errnoを指定すること
+    命令セット固有の関数（SIMD_TARGET付き）はalways_inlineにしない
+    （汎用のテンプレートから呼び出し、積分カーネルに展開されたときにインライン化させるため）
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _SIMDVEC_H_
+#define _SIMDVEC_H_
+
+#pragma once
+
+#include <cmath>        // for std::sqrt
+#include <cstdint>      // for std::uint32_t
+#include <cstring>      // for std::memcpy
+#include <type_traits>  // for std::true_type, std::false_type
+#include <immintrin.h>  // for __m512d, __m256d, __m128d, __m512, __m256, __m128, __mmask8
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define SIMD_MSVC 1
+    #define SIMD_FORCEINLINE __forceinline
+    //! 関数をisaで指定した命令セット向けにコンパイルする（MSVCでは不要）
+    #define SIMD_TARGET(isa)
+    //! 関数の中で積和を融合させない（MSVCは/fp:preciseでは融合しないので不要）
+    #define SIMD_PRECISE
+#else
+    #define SIMD_FORCEINLINE inline __attribute__((always_inline))
+    //! 関数をisaで指定した命令セット向けにコンパイルする
+    //! 呼び出す関数（被積分関数を含む）もすべてインライン展開して、同じ命令セット向けにコンパイルされるようにする
+    //! （SIMDベクトルを値で受け取る関数が別の命令セット向けにコンパイルされると、引数の渡し方が一致しない）
+    #define SIMD_TARGET(isa) __attribute__((target(isa), flatten))
+    #if defined(__clang__)
+        //! 関数の中で積和を融合させない（Clangには関数単位の指定がないので、-ffp-contract=offでコンパイルする）
+        #define SIMD_PRECISE __attribute__((flatten))
+    #else
+        //! 関数の中で積和を融合させない
+        //! 呼び出す関数（被積分関数を含む）もすべてインライン展開して、同じ指定でコンパイルされるようにする
+        #define SIMD_PRECISE __attribute__((optimize("fp-contract=off"), flatten))
+    #endif
+#endif
+
+namespace simd {
+    //! A class.
+    /*!
+        倍精度浮動小数点数8個からなるSIMDベクトル（AVX-512）
+    */
+    class F64vec8 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F64vec8() = default;
+
+        //! A constructor.
+        /*!
+            __m512dから構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F64vec8(__m512d v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をdで初期化する
+            \param d 格納する値
+        */
+        SIMD_FORCEINLINE F64vec8(double d)
+#ifdef SIMD_MSVC
+            : vec(_mm512_set1_pd(d))
+#else
+            : vec(__m512d{ d, d, d, d, d, d, d, d })
+#endif
+        {}
+
+        //! A constructor.
+        /*!
+            F64vec4と同じく、上位の要素から順に指定して初期化する
+            \param d7 要素7の値
+            \param d6 要素6の値
+            \param d5 要素5の値
+            \param d4 要素4の値
+            \param d3 要素3の値
+            \param d2 要素2の値
+            \param d1 要素1の値
+            \param d0 要素0の値
+        */
+        SIMD_FORCEINLINE F64vec8(double d7, double d6, double d5, double d4, double d3, double d2, double d1, double d0)
+#ifdef SIMD_MSVC
+            : vec(_mm512_set_pd(d7, d6, d5, d4, d3, d2, d1, d0))
+#else
+            : vec(__m512d{ d0, d1, d2, d3, d4, d5, d6, d7 })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            64バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec8 load(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm512_load_pd(p);
+#else
+            return *reinterpret_cast<__m512d const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec8 loadu(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm512_loadu_pd(p);
+#else
+            __m512d v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            先頭のcount要素だけをマスク付きの命令でメモリから読み込み、残りの要素はfillで埋める
+            \param p 読み込むメモリの先頭アドレス
+            \param count 読み込む要素の数（1以上8未満）
+            \param fill 残りの要素を埋める値
+            \return 読み込んだベクトル
+        */
+        static SIMD_TARGET("avx512f") inline F64vec8 loadpartial(double const * p, std::uint32_t count, double fill)
+        {
+            return _mm512_mask_loadu_pd(_mm512_set1_pd(fill), static_cast<__mmask8>((1U << count) - 1U), p);
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(double * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm512_storeu_pd(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            先頭のcount要素だけをマスク付きの命令でメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+            \param count 書き込む要素の数（1以上8未満）
+        */
+        SIMD_TARGET("avx512f") inline void storepartial(double * p, std::uint32_t count) const
+        {
+            _mm512_mask_storeu_pd(p, static_cast<__mmask8>((1U << count) - 1U), vec);
+        }
+
+        //! A public member function.
+        /*!
+            __m512dへの変換演算子
+        */
+        SIMD_TARGET("avx512f") inline operator __m512d() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE double operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m512d_f64[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m512d vec;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        倍精度浮動小数点数4個からなるSIMDベクトル（AVX）
+    */
+    class F64vec4 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F64vec4() = default;
+
+        //! A constructor.
+        /*!
+            __m256dから構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F64vec4(__m256d v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をdで初期化する
+            \param d 格納する値
+        */
+        SIMD_FORCEINLINE F64vec4(double d)
+#ifdef SIMD_MSVC
+            : vec(_mm256_set1_pd(d))
+#else
+            : vec(__m256d{ d, d, d, d })
+#endif
+        {}
+
+        //! A constructor.
+        /*!
+            dvec.hのF64vec4と同じく、上位の要素から順に指定して初期化する
+            \param d3 要素3の値
+            \param d2 要素2の値
+            \param d1 要素1の値
+            \param d0 要素0の値
+        */
+        SIMD_FORCEINLINE F64vec4(double d3, double d2, double d1, double d0)
+#ifdef SIMD_MSVC
+            : vec(_mm256_set_pd(d3, d2, d1, d0))
+#else
+            : vec(__m256d{ d0, d1, d2, d3 })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            32バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec4 load(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm256_load_pd(p);
+#else
+            return *reinterpret_cast<__m256d const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec4 loadu(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm256_loadu_pd(p);
+#else
+            __m256d v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            先頭のcount要素だけをメモリから読み込み、残りの要素はfillで埋める
+            \param p 読み込むメモリの先頭アドレス
+            \param count 読み込む要素の数（1以上4未満）
+            \param fill 残りの要素を埋める値
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec4 loadpartial(double const * p, std::uint32_t count, double fill)
+        {
+            return F64vec4(count > 3 ? p[3] : fill, count > 2 ? p[2] : fill, count > 1 ? p[1] : fill, p[0]);
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(double * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm256_storeu_pd(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            先頭のcount要素だけをメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+            \param count 書き込む要素の数（1以上4未満）
+        */
+        SIMD_FORCEINLINE void storepartial(double * p, std::uint32_t count) const
+        {
+            for (auto i = 0U; i < count; i++) {
+                p[i] = (*this)[static_cast<int>(i)];
+            }
+        }
+
+        //! A public member function.
+        /*!
+            __m256dへの変換演算子
+        */
+        SIMD_TARGET("avx") inline operator __m256d() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE double operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m256d_f64[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m256d vec;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        倍精度浮動小数点数2個からなるSIMDベクトル（SSE2）
+    */
+    class F64vec2 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F64vec2() = default;
+
+        //! A constructor.
+        /*!
+            __m128dから構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F64vec2(__m128d v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をdで初期化する
+            \param d 格納する値
+        */
+        SIMD_FORCEINLINE F64vec2(double d)
+#ifdef SIMD_MSVC
+            : vec(_mm_set1_pd(d))
+#else
+            : vec(__m128d{ d, d })
+#endif
+        {}
+
+        //! A constructor.
+        /*!
+            dvec.hのF64vec2と同じく、上位の要素から順に指定して初期化する
+            \param d1 要素1の値
+            \param d0 要素0の値
+        */
+        SIMD_FORCEINLINE F64vec2(double d1, double d0)
+#ifdef SIMD_MSVC
+            : vec(_mm_set_pd(d1, d0))
+#else
+            : vec(__m128d{ d0, d1 })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            16バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec2 load(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm_load_pd(p);
+#else
+            return *reinterpret_cast<__m128d const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec2 loadu(double const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm_loadu_pd(p);
+#else
+            __m128d v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            先頭のcount要素だけをメモリから読み込み、残りの要素はfillで埋める
+            \param p 読み込むメモリの先頭アドレス
+            \param count 読み込む要素の数（1以上2未満）
+            \param fill 残りの要素を埋める値
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F64vec2 loadpartial(double const * p, std::uint32_t count, double fill)
+        {
+            return F64vec2(count > 1 ? p[1] : fill, p[0]);
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(double * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm_storeu_pd(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            先頭のcount要素だけをメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+            \param count 書き込む要素の数（1以上2未満）
+        */
+        SIMD_FORCEINLINE void storepartial(double * p, std::uint32_t count) const
+        {
+            for (auto i = 0U; i < count; i++) {
+                p[i] = (*this)[static_cast<int>(i)];
+            }
+        }
+
+        //! A public member function.
+        /*!
+            __m128dへの変換演算子
+        */
+        SIMD_FORCEINLINE operator __m128d() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE double operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m128d_f64[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m128d vec;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        単精度浮動小数点数16個からなるSIMDベクトル（AVX-512）
+    */
+    class F32vec16 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F32vec16() = default;
+
+        //! A constructor.
+        /*!
+            __m512から構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F32vec16(__m512 v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をfで初期化する
+            \param f 格納する値
+        */
+        SIMD_FORCEINLINE F32vec16(float f)
+#ifdef SIMD_MSVC
+            : vec(_mm512_set1_ps(f))
+#else
+            : vec(__m512{ f, f, f, f, f, f, f, f, f, f, f, f, f, f, f, f })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            64バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec16 load(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm512_load_ps(p);
+#else
+            return *reinterpret_cast<__m512 const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec16 loadu(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm512_loadu_ps(p);
+#else
+            __m512 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(float * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm512_storeu_ps(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            __m512への変換演算子
+        */
+        SIMD_TARGET("avx512f") inline operator __m512() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE float operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m512_f32[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m512 vec;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        単精度浮動小数点数8個からなるSIMDベクトル（AVX）
+    */
+    class F32vec8 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F32vec8() = default;
+
+        //! A constructor.
+        /*!
+            __m256から構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F32vec8(__m256 v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をfで初期化する
+            \param f 格納する値
+        */
+        SIMD_FORCEINLINE F32vec8(float f)
+#ifdef SIMD_MSVC
+            : vec(_mm256_set1_ps(f))
+#else
+            : vec(__m256{ f, f, f, f, f, f, f, f })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            32バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec8 load(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm256_load_ps(p);
+#else
+            return *reinterpret_cast<__m256 const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec8 loadu(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm256_loadu_ps(p);
+#else
+            __m256 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(float * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm256_storeu_ps(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            __m256への変換演算子
+        */
+        SIMD_TARGET("avx") inline operator __m256() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE float operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m256_f32[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m256 vec;
+
+        // #endregion メンバ変数
+    };
+
+    //! A class.
+    /*!
+        単精度浮動小数点数4個からなるSIMDベクトル（SSE）
+    */
+    class F32vec4 final {
+    public:
+        // #region コンストラクタ
+
+        //! A constructor.
+        /*!
+            デフォルトコンストラクタ（値は不定）
+        */
+        F32vec4() = default;
+
+        //! A constructor.
+        /*!
+            __m128から構築する
+            \param v 格納する値
+        */
+        SIMD_FORCEINLINE F32vec4(__m128 v) : vec(v) {}
+
+        //! A constructor.
+        /*!
+            すべての要素をfで初期化する
+            \param f 格納する値
+        */
+        SIMD_FORCEINLINE F32vec4(float f)
+#ifdef SIMD_MSVC
+            : vec(_mm_set1_ps(f))
+#else
+            : vec(__m128{ f, f, f, f })
+#endif
+        {}
+
+        // #endregion コンストラクタ
+
+        // #region メンバ関数
+
+        //! A public static member function.
+        /*!
+            16バイト境界に揃ったメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec4 load(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm_load_ps(p);
+#else
+            return *reinterpret_cast<__m128 const *>(p);
+#endif
+        }
+
+        //! A public static member function.
+        /*!
+            境界の揃っていないメモリから読み込む
+            \param p 読み込むメモリの先頭アドレス
+            \return 読み込んだベクトル
+        */
+        static SIMD_FORCEINLINE F32vec4 loadu(float const * p)
+        {
+#ifdef SIMD_MSVC
+            return _mm_loadu_ps(p);
+#else
+            __m128 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            境界の揃っていないメモリに書き込む
+            \param p 書き込むメモリの先頭アドレス
+        */
+        SIMD_FORCEINLINE void storeu(float * p) const
+        {
+#ifdef SIMD_MSVC
+            _mm_storeu_ps(p, vec);
+#else
+            std::memcpy(p, &vec, sizeof(vec));
+#endif
+        }
+
+        //! A public member function.
+        /*!
+            __m128への変換演算子
+        */
+        SIMD_FORCEINLINE operator __m128() const
+        {
+            return vec;
+        }
+
+        //! A public member function.
+        /*!
+            i番目の要素を返す
+            \param i 要素の番号
+            \return i番目の要素
+        */
+        SIMD_FORCEINLINE float operator[](int i) const
+        {
+#ifdef SIMD_MSVC
+            return vec.m128_f32[i];
+#else
+            return vec[i];
+#endif
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public member variable.
+        /*!
+            ベクトルの値
+        */
+        __m128 vec;
+
+        // #endregion メンバ変数
+    };
+
+    // #region F64vec8の非メンバ関数
+
+    SIMD_FORCEINLINE F64vec8 operator+(F64vec8 const & a, F64vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_add_pd(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec8 operator-(F64vec8 const & a, F64vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_sub_pd(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec8 operator*(F64vec8 const & a, F64vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_mul_pd(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec8 operator/(F64vec8 const & a, F64vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_div_pd(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec8 & operator+=(F64vec8 & a, F64vec8 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F64vec8 & operator*=(F64vec8 & a, F64vec8 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        a * b + cを一回の丸めで計算する（FMA）
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    SIMD_TARGET("avx512f") inline F64vec8 fmadd(F64vec8 const & a, F64vec8 const & b, F64vec8 const & c)
+    {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F64vec8 sqrt(F64vec8 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_sqrt_pd(a);
+#else
+        return __m512d{
+            std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]),
+            std::sqrt(a[4]), std::sqrt(a[5]), std::sqrt(a[6]), std::sqrt(a[7]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F64vec8 const & a)
+    {
+        return ((a[0] + a[1]) + (a[2] + a[3])) + ((a[4] + a[5]) + (a[6] + a[7]));
+    }
+
+    // #endregion F64vec8の非メンバ関数
+
+    // #region F64vec4の非メンバ関数
+
+    SIMD_FORCEINLINE F64vec4 operator+(F64vec4 const & a, F64vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_add_pd(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec4 operator-(F64vec4 const & a, F64vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_sub_pd(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec4 operator*(F64vec4 const & a, F64vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_mul_pd(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec4 operator/(F64vec4 const & a, F64vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_div_pd(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec4 & operator+=(F64vec4 & a, F64vec4 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F64vec4 & operator*=(F64vec4 & a, F64vec4 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        a * b + cを一回の丸めで計算する（FMA）
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    SIMD_TARGET("fma") inline F64vec4 fmadd(F64vec4 const & a, F64vec4 const & b, F64vec4 const & c)
+    {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F64vec4 sqrt(F64vec4 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_sqrt_pd(a);
+#else
+        return __m256d{ std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F64vec4 const & a)
+    {
+        return (a[0] + a[1]) + (a[2] + a[3]);
+    }
+
+    // #endregion F64vec4の非メンバ関数
+
+    // #region F64vec2の非メンバ関数
+
+    SIMD_FORCEINLINE F64vec2 operator+(F64vec2 const & a, F64vec2 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_add_pd(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec2 operator-(F64vec2 const & a, F64vec2 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_sub_pd(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec2 operator*(F64vec2 const & a, F64vec2 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_mul_pd(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec2 operator/(F64vec2 const & a, F64vec2 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_div_pd(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F64vec2 & operator+=(F64vec2 & a, F64vec2 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F64vec2 & operator*=(F64vec2 & a, F64vec2 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F64vec2 sqrt(F64vec2 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm_sqrt_pd(a);
+#else
+        return __m128d{ std::sqrt(a[0]), std::sqrt(a[1]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F64vec2 const & a)
+    {
+        return a[0] + a[1];
+    }
+
+    // #endregion F64vec2の非メンバ関数
+
+    // #region F32vec16の非メンバ関数
+
+    SIMD_FORCEINLINE F32vec16 operator+(F32vec16 const & a, F32vec16 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_add_ps(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec16 operator-(F32vec16 const & a, F32vec16 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_sub_ps(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec16 operator*(F32vec16 const & a, F32vec16 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_mul_ps(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec16 operator/(F32vec16 const & a, F32vec16 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_div_ps(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec16 & operator+=(F32vec16 & a, F32vec16 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F32vec16 & operator*=(F32vec16 & a, F32vec16 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        a * b + cを一回の丸めで計算する（FMA）
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    SIMD_TARGET("avx512f") inline F32vec16 fmadd(F32vec16 const & a, F32vec16 const & b, F32vec16 const & c)
+    {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の絶対値を返す
+        \param a 引数のベクトル
+        \return 各要素の絶対値
+    */
+    SIMD_TARGET("avx512f") inline F32vec16 abs(F32vec16 const & a)
+    {
+        return _mm512_abs_ps(a);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F32vec16 sqrt(F32vec16 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm512_sqrt_ps(a);
+#else
+        return __m512{
+            std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]),
+            std::sqrt(a[4]), std::sqrt(a[5]), std::sqrt(a[6]), std::sqrt(a[7]),
+            std::sqrt(a[8]), std::sqrt(a[9]), std::sqrt(a[10]), std::sqrt(a[11]),
+            std::sqrt(a[12]), std::sqrt(a[13]), std::sqrt(a[14]), std::sqrt(a[15]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を倍精度で求めて返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F32vec16 const & a)
+    {
+        return (((static_cast<double>(a[0]) + static_cast<double>(a[1])) + (static_cast<double>(a[2]) + static_cast<double>(a[3]))) + ((static_cast<double>(a[4]) + static_cast<double>(a[5])) + (static_cast<double>(a[6]) + static_cast<double>(a[7])))) + (((static_cast<double>(a[8]) + static_cast<double>(a[9])) + (static_cast<double>(a[10]) + static_cast<double>(a[11]))) + ((static_cast<double>(a[12]) + static_cast<double>(a[13])) + (static_cast<double>(a[14]) + static_cast<double>(a[15]))));
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        下位8個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 下位8個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("avx512f") inline F64vec8 widenlo(F32vec16 const & a)
+    {
+        return _mm512_cvtps_pd(_mm512_castps512_ps256(a));
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        上位8個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 上位8個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("avx512f") inline F64vec8 widenhi(F32vec16 const & a)
+    {
+        return _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+    }
+
+    // #endregion F32vec16の非メンバ関数
+
+    // #region F32vec8の非メンバ関数
+
+    SIMD_FORCEINLINE F32vec8 operator+(F32vec8 const & a, F32vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_add_ps(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec8 operator-(F32vec8 const & a, F32vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_sub_ps(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec8 operator*(F32vec8 const & a, F32vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_mul_ps(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec8 operator/(F32vec8 const & a, F32vec8 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_div_ps(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec8 & operator+=(F32vec8 & a, F32vec8 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F32vec8 & operator*=(F32vec8 & a, F32vec8 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        a * b + cを一回の丸めで計算する（FMA）
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    SIMD_TARGET("fma") inline F32vec8 fmadd(F32vec8 const & a, F32vec8 const & b, F32vec8 const & c)
+    {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の絶対値を返す
+        \param a 引数のベクトル
+        \return 各要素の絶対値
+    */
+    SIMD_TARGET("avx") inline F32vec8 abs(F32vec8 const & a)
+    {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F32vec8 sqrt(F32vec8 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm256_sqrt_ps(a);
+#else
+        return __m256{ std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]), std::sqrt(a[4]), std::sqrt(a[5]), std::sqrt(a[6]), std::sqrt(a[7]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を倍精度で求めて返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F32vec8 const & a)
+    {
+        return ((static_cast<double>(a[0]) + static_cast<double>(a[1])) + (static_cast<double>(a[2]) + static_cast<double>(a[3]))) + ((static_cast<double>(a[4]) + static_cast<double>(a[5])) + (static_cast<double>(a[6]) + static_cast<double>(a[7])));
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        下位4個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 下位4個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("avx") inline F64vec4 widenlo(F32vec8 const & a)
+    {
+        return _mm256_cvtps_pd(_mm256_castps256_ps128(a));
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        上位4個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 上位4個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("avx") inline F64vec4 widenhi(F32vec8 const & a)
+    {
+        return _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1));
+    }
+
+    // #endregion F32vec8の非メンバ関数
+
+    // #region F32vec4の非メンバ関数
+
+    SIMD_FORCEINLINE F32vec4 operator+(F32vec4 const & a, F32vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_add_ps(a, b);
+#else
+        return a.vec + b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec4 operator-(F32vec4 const & a, F32vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_sub_ps(a, b);
+#else
+        return a.vec - b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec4 operator*(F32vec4 const & a, F32vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_mul_ps(a, b);
+#else
+        return a.vec * b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec4 operator/(F32vec4 const & a, F32vec4 const & b)
+    {
+#ifdef SIMD_MSVC
+        return _mm_div_ps(a, b);
+#else
+        return a.vec / b.vec;
+#endif
+    }
+
+    SIMD_FORCEINLINE F32vec4 & operator+=(F32vec4 & a, F32vec4 const & b)
+    {
+        return a = a + b;
+    }
+
+    SIMD_FORCEINLINE F32vec4 & operator*=(F32vec4 & a, F32vec4 const & b)
+    {
+        return a = a * b;
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の絶対値を返す
+        \param a 引数のベクトル
+        \return 各要素の絶対値
+    */
+    SIMD_TARGET("sse2") inline F32vec4 abs(F32vec4 const & a)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        各要素の平方根を返す
+        \param a 引数のベクトル
+        \return 各要素の平方根
+    */
+    SIMD_FORCEINLINE F32vec4 sqrt(F32vec4 const & a)
+    {
+#ifdef SIMD_MSVC
+        return _mm_sqrt_ps(a);
+#else
+        return __m128{ std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]) };
+#endif
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        全要素の和を倍精度で求めて返す
+        \param a 引数のベクトル
+        \return 全要素の和
+    */
+    SIMD_FORCEINLINE double add_horizontal(F32vec4 const & a)
+    {
+        return (static_cast<double>(a[0]) + static_cast<double>(a[1])) + (static_cast<double>(a[2]) + static_cast<double>(a[3]));
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        下位2個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 下位2個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("sse2") inline F64vec2 widenlo(F32vec4 const & a)
+    {
+        return _mm_cvtps_pd(a);
+    }
+
+    //! A function（非メンバ関数）.
+    /*!
+        上位2個の要素を倍精度に変換する
+        \param a 引数のベクトル
+        \return 上位2個の要素を倍精度に変換したベクトル
+    */
+    SIMD_TARGET("sse2") inline F64vec2 widenhi(F32vec4 const & a)
+    {
+        return _mm_cvtps_pd(_mm_movehl_ps(a, a));
+    }
+
+    // #endregion F32vec4の非メンバ関数
+
+    // #region 型に依存しない非メンバ関数
+
+    //! A template function（非メンバ関数）.
+    /*!
+        a * b + cをFMAを使って計算する
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    template <typename VEC>
+    SIMD_FORCEINLINE VEC muladd(VEC const & a, VEC const & b, VEC const & c, std::true_type)
+    {
+        return fmadd(a, b, c);
+    }
+
+    //! A template function（非メンバ関数）.
+    /*!
+        a * b + cをFMAを使わずに計算する
+        \param a 引数のベクトル
+        \param b 引数のベクトル
+        \param c 引数のベクトル
+        \return a * b + c
+    */
+    template <typename VEC>
+    SIMD_FORCEINLINE VEC muladd(VEC const & a, VEC const & b, VEC const & c, std::false_type)
+    {
+        return a * b + c;
+    }
+
+#ifdef SIMD_MSVC
+    // TwoSumとTwoProdは、/fp:fastでコンパイルしても式を並べ替えたり積和を融合したりさせない
+    #pragma float_control(precise, on, push)
+#endif
+
+    //! A template function（非メンバ関数）.
+    /*!
+        a + bを誤差なしで s + e に分解する（KnuthのTwoSum）
+        分岐を含まないので、SIMDベクトルにもそのまま使える
+        MSVCでは/fp:fastでも正しく計算されるが、GCCやClangの-ffast-mathを有効にすると誤差eが失われる
+        \param a 引数
+        \param b 引数
+        \param e a + bの丸め誤差
+        \return a + bの丸めた値
+    */
+    template <typename T>
+    SIMD_FORCEINLINE T twosum(T const & a, T const & b, T & e)
+    {
+        T const s = a + b;
+        T const z = s - a;
+        e = (a - (s - z)) + (b - z);
+        return s;
+    }
+
+    //! A template function（非メンバ関数）.
+    /*!
+        a * bを誤差なしで p + e に分解する（FMAを使うTwoProd）
+        \param a 引数
+        \param b 引数
+        \param e a * bの丸め誤差
+        \return a * bの丸めた値
+    */
+    template <typename T>
+    SIMD_FORCEINLINE T twoprod(T const & a, T const & b, T & e, std::true_type)
+    {
+        T const p = a * b;
+        e = fmadd(a, b, T(T(0.0) - p));
+        return p;
+    }
+
+    //! A template function（非メンバ関数）.
+    /*!
+        a * bを誤差なしで p + e に分解する（FMAを使わない、Veltkampの分割によるDekkerのTwoProd）
+        \param a 引数
+        \param b 引数
+        \param e a * bの丸め誤差
+        \return a * bの丸めた値
+    */
+    template <typename T>
+    SIMD_FORCEINLINE T twoprod(T const & a, T const & b, T & e, std::false_type)
+    {
+        // 2^27 + 1で、仮数部を上位と下位の26ビットずつに分ける
+        T const split(134217729.0);
+        T const ca = split * a;
+        T const ah = ca - (ca - a);
+        T const al = a - ah;
+        T const cb = split * b;
+        T const bh = cb - (cb - b);
+        T const bl = b - bh;
+
+        T const p = a * b;
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+        return p;
+    }
+
+#ifdef SIMD_MSVC
+    #pragma float_control(pop)
+#endif
+
+    //! A template function（非メンバ関数）.
+    /*!
+        N個の要素を、要素の並びだけで決まる二分木で足し合わせる（配列の内容は壊れる）
+        \param a 足し合わせる配列（N要素、Nは2の冪）
+        \return 全要素の和
+    */
+    template <std::uint32_t N>
+    SIMD_FORCEINLINE double add_pairwise(double * a)
+    {
+        for (auto width = N / 2; width; width /= 2) {
+            for (auto i = 0U; i < width; i++) {
+                a[i] += a[i + width];
+            }
+        }
+
+        return a[0];
+    }
+
+    // #endregion 型に依存しない非メンバ関数
+}
+
+#endif  // _SIMDVEC_H_
@@ -0,0 +1,128 @@
+﻿/*! \file summation.h
+    \brief 積分カーネルが重み付きの和を求める関数（累積変数への足し込みと、Summation::Reproducibleの和）の宣言と実装
+    Gauss_LegendreクラスとPlanクラスで共通に使う
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _SUMMATION_H_
+#define _SUMMATION_H_
+
+#pragma once
+
+#include "kernel.h"
+#include "simdvec.h"    // for simd::muladd, simd::twoprod, simd::twosum, simd::add_pairwise
+#include <array>        // for std::array
+#include <cstdint>      // for std::uint32_t
+#include <type_traits>  // for std::false_type
+
+namespace gausslegendre {
+    //! A global variable (constant).
+    /*!
+        積分カーネルが使う独立した累積変数の数
+    */
+    std::uint32_t constexpr ACCUMULATORS = 4;
+
+    //! A global variable (constant).
+    /*!
+        Summation::Reproducibleで使う累積変数の数（最も長いSIMDベクトルの要素数の倍数）
+    */
+    std::uint32_t constexpr REPROLANES = 16;
+
+    //! A template function.
+    /*!
+        重みwと関数値fの積を累積変数に足し込む
+        \param w 重み
+        \param f 関数値
+        \param sum 累積変数
+        \param comp 累積変数の丸め誤差（SUMMATIONがSummation::Naiveでないときのみ使用）
+        \param usefma FMAを使うかどうか
+    */
+    template <Summation SUMMATION, typename VEC, typename USEFMA>
+    SIMD_FORCEINLINE void accumulate(VEC const & w, VEC const & f, VEC & sum, VEC & comp, USEFMA usefma);
+
+    //! A template function.
+    /*!
+        Summation::Reproducibleの重み付きの和を、SIMDを使わずに求める
+        節i（beginからの番号）はi % REPROLANES番目の累積変数に節の順に足し込み、FMAは使わない
+        累積変数は最後に、要素の並びだけで決まる二分木で足し合わせる
+        \param w 重みの配列
+        \param begin 和を取る節の範囲の先頭
+        \param last 和を取る節の範囲の末尾の次（埋め草を含めて、最も長いSIMDベクトルの要素数の倍数）
+        \param f 節の添字を受け取り、その節での関数値を返す関数
+        \return 重み付きの和
+    */
+    template <typename FUNC>
+    SIMD_FORCEINLINE double reproducibleSum(double const * w, std::uint32_t begin, std::uint32_t last, FUNC const & f);
+
+    //! A template function.
+    /*!
+        Summation::Reproducibleの重み付きの和を、SIMDベクトルの型VECを使ってreproducibleSumと同じ順序で求める
+        REPROLANES / W個のベクトルの累積変数を並べ、ベクトルkの要素jをreproducibleSumの累積変数k * W + jに対応させる
+        \param w 重みの配列（beginがALIGNMENTバイト境界に揃っていること）
+        \param begin 和を取る節の範囲の先頭
+        \param last 和を取る節の範囲の末尾の次（埋め草を含めて、最も長いSIMDベクトルの要素数の倍数）
+        \param f 節の添字jを受け取り、節jからのW個の節での関数値をVECで返す関数
+        \return 重み付きの和
+    */
+    template <typename VEC, typename FUNC>
+    SIMD_FORCEINLINE double reproducibleSumSimd(double const * w, std::uint32_t begin, std::uint32_t last, FUNC const & f);
+
+    template <Summation SUMMATION, typename VEC, typename USEFMA>
+    inline void accumulate(VEC const & w, VEC const & f, VEC & sum, VEC & comp, USEFMA usefma)
+    {
+        if (SUMMATION == Summation::DoubleDouble) {
+            // 積の丸め誤差もTwoProdで拾う（Ogita-Rump-OishiのDot2）
+            VEC pe, e;
+            sum = simd::twosum(sum, simd::twoprod(w, f, pe, usefma), e);
+            comp += e + pe;
+        }
+        else if (SUMMATION == Summation::Compensated) {
+            VEC e;
+            sum = simd::twosum(sum, VEC(w * f), e);
+            comp += e;
+        }
+        else {
+            sum = simd::muladd(w, f, sum, usefma);
+        }
+    }
+
+    template <typename FUNC>
+    inline double reproducibleSum(double const * w, std::uint32_t begin, std::uint32_t last, FUNC const & f)
+    {
+        std::array<double, REPROLANES> lane = {};
+        for (auto i = begin; i < last; i += REPROLANES) {
+            for (auto k = 0U; k < REPROLANES && i + k < last; k++) {
+                accumulate<Summation::Naive>(w[i + k], static_cast<double>(f(i + k)), lane[k], lane[k], std::false_type());
+            }
+        }
+
+        return simd::add_pairwise<REPROLANES>(lane.data());
+    }
+
+    template <typename VEC, typename FUNC>
+    inline double reproducibleSumSimd(double const * w, std::uint32_t begin, std::uint32_t last, FUNC const & f)
+    {
+        static auto constexpr W = static_cast<std::uint32_t>(sizeof(VEC) / sizeof(double));
+        static auto constexpr M = REPROLANES / W;
+
+        std::array<VEC, M> sum;
+        sum.fill(VEC(0.0));
+        for (auto i = begin; i < last; i += REPROLANES) {
+            for (auto k = 0U; k < M; k++) {
+                auto const j = i + k * W;
+                if (j < last) {
+                    accumulate<Summation::Naive>(VEC::load(&w[j]), VEC(f(j)), sum[k], sum[k], std::false_type());
+                }
+            }
+        }
+
+        std::array<double, REPROLANES> lane;
+        for (auto k = 0U; k < M; k++) {
+            sum[k].storeu(&lane[k * W]);
+        }
+
+        return simd::add_pairwise<REPROLANES>(lane.data());
+    }
+}
+
+#endif  // _SUMMATION_H_
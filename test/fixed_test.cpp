@@ -0,0 +1,152 @@
+﻿/*! \file fixed_test.cpp
+    \brief Gauss_Legendre_Fixedがコンパイル時に求めた節と重みを、long doubleで求めた参照値と比較するテスト
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "Gauss_Legendre_Fixed.h"
+#include "reference.h"
+#include <cmath>        // for std::fabs
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <iostream>     // for std::cout
+#include <utility>      // for std::integer_sequence, std::make_integer_sequence
+#include <vector>       // for std::vector
+
+namespace {
+    //! A global variable (constant).
+    /*!
+        Gauss_Legendre_Fixedの分点の上限
+    */
+    static auto constexpr MAXFIXED = 64U;
+
+    //! A global variable (constant).
+    /*!
+        節の許容誤差（絶対誤差）
+    */
+    static auto constexpr NODETOLERANCE = 1.0E-15;
+
+    //! A global variable (constant).
+    /*!
+        重みの許容誤差（相対誤差）
+    */
+    static auto constexpr WEIGHTTOLERANCE = 1.0E-15;
+
+    //! A global variable (constant).
+    /*!
+        積分値の許容誤差（相対誤差）
+    */
+    static auto constexpr INTEGRALTOLERANCE = 1.0E-14;
+
+    //! A struct.
+    /*!
+        配列をまとめて評価する形を持つ被積分関数（f(x) = x^3 + x）
+    */
+    struct Batch final {
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            \param x xの値
+            \return f(x)の値
+        */
+        double operator()(double x) const
+        {
+            return x * x * x + x;
+        }
+
+        //! A public member function.
+        /*!
+            operator()の宣言と実装
+            \param x xの値の配列
+            \param y f(x)の値を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * x, double * y, std::size_t n) const
+        {
+            for (std::size_t i = 0; i < n; i++) {
+                y[i] = x[i] * x[i] * x[i] + x[i];
+            }
+        }
+    };
+
+    //! A template function.
+    /*!
+        N点の節と重みを、long doubleで求めた参照値と比較する
+        \param N Gauss-Legendreの分点
+        \return 誤差が許容誤差以下ならtrue
+    */
+    template <std::uint32_t N>
+    bool testReference()
+    {
+        std::vector<double> x(N), w(N), xref(N), wref(N);
+        for (auto i = 0U; i < N; i++) {
+            x[i] = gausslegendre::Gauss_Legendre_Fixed<N>::x(i);
+            w[i] = gausslegendre::Gauss_Legendre_Fixed<N>::w(i);
+        }
+
+        reference::nodes(N, xref, wref);
+
+        auto const error = reference::maxError(x, w, xref, wref);
+        if (error.x <= NODETOLERANCE && error.w <= WEIGHTTOLERANCE) {
+            return true;
+        }
+
+        std::cout << "n = " << N << ", 節の誤差 = " << error.x << ", 重みの相対誤差 = " << error.w << std::endl;
+        return false;
+    }
+
+    //! A template function.
+    /*!
+        節ごと、SIMDベクトルごと、配列をまとめて評価する三つの形の被積分関数で、x^3 + xを[0, 2]で積分する
+        \param N Gauss-Legendreの分点（2以上、3次の多項式を厳密に積分できる）
+        \return 三つの積分値が、いずれも厳密値（6）との許容誤差以下ならtrue
+    */
+    template <std::uint32_t N>
+    bool testIntegral()
+    {
+        gausslegendre::Gauss_Legendre_Fixed<N> const gl;
+        auto const f = [](auto x) { return x * x * x + x; };
+
+        double const result[] = {
+            gl.qgauss(myfunctional::make_functional(f), 0.0, 2.0),
+            gl.qgauss(myfunctional::make_vectorfunctional(f), 0.0, 2.0),
+            gl.qgauss(myfunctional::make_vectorfunctional(Batch()), 0.0, 2.0)
+        };
+
+        auto ok = true;
+        for (auto r : result) {
+            if (std::fabs(r - 6.0) > INTEGRALTOLERANCE * 6.0) {
+                std::cout << "n = " << N << ", 積分値 = " << r << std::endl;
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    //! A template function.
+    /*!
+        1からsizeof...(I)までのすべての分点について、節と重みと積分値を調べる
+        \return すべての分点で誤差が許容誤差以下ならtrue
+    */
+    template <std::uint32_t... I>
+    bool testAll(std::integer_sequence<std::uint32_t, I...>)
+    {
+        bool const tables[] = { testReference<I + 1>()... };
+        bool const integral[] = { (I + 1 < 2 || testIntegral<I + 1>())... };
+
+        auto ok = true;
+        for (auto i = 0U; i < sizeof...(I); i++) {
+            ok = ok && tables[i] && integral[i];
+        }
+
+        return ok;
+    }
+}
+
+int main()
+{
+    auto const ok = testAll(std::make_integer_sequence<std::uint32_t, MAXFIXED>());
+
+    std::cout << (ok ? "OK" : "NG") << std::endl;
+    return ok ? 0 : 1;
+}
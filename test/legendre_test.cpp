@@ -0,0 +1,122 @@
+﻿/*! \file legendre_test.cpp
+    \brief legendreNodesが求めた節と重みを、long doubleで求めた参照値とALGLIBの値と比較するテスト
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "integration.h"
+#include "legendre.h"
+#include "reference.h"
+#include <cstdint>      // for std::uint32_t
+#include <iostream>     // for std::cout
+#include <vector>       // for std::vector
+
+namespace {
+    //! A global variable (constant).
+    /*!
+        long doubleの参照値と比較する分点の上限（これ以下のすべての分点と、いくつかの大きな分点を調べる）
+    */
+    static auto constexpr MAXREFERENCE = 100U;
+
+    //! A global variable (constant).
+    /*!
+        ALGLIBの値と比較する分点の上限
+    */
+    static auto constexpr MAXALGLIB = 64U;
+
+    //! A global variable (constant).
+    /*!
+        節の許容誤差（絶対誤差）
+    */
+    static auto constexpr NODETOLERANCE = 1.0E-14;
+
+    //! A global variable (constant).
+    /*!
+        重みの許容誤差（相対誤差）
+    */
+    static auto constexpr WEIGHTTOLERANCE = 1.0E-14;
+
+    //! A global variable (constant).
+    /*!
+        ALGLIBの重みと比較するときの許容誤差（相対誤差）
+        ALGLIBの重み自体が、long doubleの参照値と最大で4e-13程度（n = 63）ずれている
+    */
+    static auto constexpr ALGLIBWEIGHTTOLERANCE = 1.0E-12;
+
+    //! A function.
+    /*!
+        誤差が許容誤差以下かどうかを調べ、許容誤差を超えていればその旨を表示する
+        \param name 比較の対象の名前
+        \param n Gauss-Legendreの分点
+        \param error 誤差
+        \param wtolerance 重みの許容誤差
+        \return 誤差が許容誤差以下ならtrue
+    */
+    bool check(char const * name, std::uint32_t n, reference::Error const & error, double wtolerance)
+    {
+        if (error.x <= NODETOLERANCE && error.w <= wtolerance) {
+            return true;
+        }
+
+        std::cout << name << ": n = " << n << ", 節の誤差 = " << error.x << ", 重みの相対誤差 = " << error.w << std::endl;
+        return false;
+    }
+
+    //! A function.
+    /*!
+        n点の節と重みを、long doubleで求めた参照値と比較する
+        \param n Gauss-Legendreの分点
+        \return 誤差が許容誤差以下ならtrue
+    */
+    bool testReference(std::uint32_t n)
+    {
+        std::vector<double> x(n), w(n), xref(n), wref(n);
+        gausslegendre::legendreNodes(n, x.data(), w.data());
+        reference::nodes(n, xref, wref);
+
+        return check("long double", n, reference::maxError(x, w, xref, wref), WEIGHTTOLERANCE);
+    }
+
+    //! A function.
+    /*!
+        n点の節と重みを、ALGLIBが求めた値と比較する
+        \param n Gauss-Legendreの分点
+        \return 誤差が許容誤差以下ならtrue
+    */
+    bool testAlglib(std::uint32_t n)
+    {
+        std::vector<double> x(n), w(n);
+        gausslegendre::legendreNodes(n, x.data(), w.data());
+
+        alglib::ae_int_t info = 0;
+        alglib::real_1d_array xa, wa;
+        alglib::gqgenerategausslegendre(n, info, xa, wa);
+        if (info != 1) {
+            std::cout << "ALGLIB: n = " << n << "の節と重みを求められない" << std::endl;
+            return false;
+        }
+
+        return check("ALGLIB", n, reference::maxError(x, w, std::vector<double>(xa.getcontent(), xa.getcontent() + n), std::vector<double>(wa.getcontent(), wa.getcontent() + n)), ALGLIBWEIGHTTOLERANCE);
+    }
+}
+
+int main()
+{
+    auto ok = true;
+
+    // 端付近の節（両端から10個ずつ）を漸化式で、それ以外をStieltjesの漸近展開で求めるので、
+    // 全ての節を漸化式で求める小さな分点から、漸近展開に切り替わる分点をまたいで調べる
+    for (auto n = 1U; n <= MAXREFERENCE; n++) {
+        ok = testReference(n) && ok;
+    }
+
+    for (auto n : { 127U, 128U, 255U, 256U, 500U, 1000U }) {
+        ok = testReference(n) && ok;
+    }
+
+    for (auto n = 1U; n <= MAXALGLIB; n++) {
+        ok = testAlglib(n) && ok;
+    }
+
+    std::cout << (ok ? "OK" : "NG") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+﻿/*! \file reference.h
+    \brief テストで使う、long doubleで求めたGauss-Legendreの節と重み（参照値）と、それとの誤差を求める関数
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#ifndef _REFERENCE_H_
+#define _REFERENCE_H_
+
+#pragma once
+
+#include <algorithm>    // for std::max
+#include <cmath>        // for std::cos, std::fabs
+#include <cstdint>      // for std::uint32_t
+#include <vector>       // for std::vector
+
+namespace reference {
+    //! A global variable (constant).
+    /*!
+        円周率
+    */
+    static auto constexpr PI = 3.14159265358979323846L;
+
+    //! A struct.
+    /*!
+        二組の節と重みの差の最大値
+    */
+    struct Error final {
+        //! A public member variable.
+        /*!
+            節の絶対誤差の最大値
+        */
+        double x;
+
+        //! A public member variable.
+        /*!
+            重みの相対誤差の最大値
+        */
+        double w;
+    };
+
+    //! A function.
+    /*!
+        n次のLegendre多項式の値と、その導関数の値を三項漸化式でlong doubleで求める
+        \param n Legendre多項式の次数
+        \param x xの値
+        \param dp P'_n(x)の値
+        \return P_n(x)の値
+    */
+    inline long double legendre(std::uint32_t n, long double x, long double & dp)
+    {
+        auto p0 = 1.0L;
+        auto p1 = x;
+        for (auto k = 2U; k <= n; k++) {
+            auto const p2 = (static_cast<long double>(2 * k - 1) * x * p1 - static_cast<long double>(k - 1) * p0) / static_cast<long double>(k);
+            p0 = p1;
+            p1 = p2;
+        }
+
+        dp = static_cast<long double>(n) * (p0 - x * p1) / (1.0L - x * x);
+        return p1;
+    }
+
+    //! A function.
+    /*!
+        n点のGauss-Legendreの節と重みを、long doubleのNewton法で求める（参照値）
+        \param n Gauss-Legendreの分点
+        \param x 節を格納する配列（n要素、昇順に格納される）
+        \param w 重みを格納する配列（n要素）
+    */
+    inline void nodes(std::uint32_t n, std::vector<double> & x, std::vector<double> & w)
+    {
+        auto const nl = static_cast<long double>(n);
+        for (auto k = 1U; k <= (n + 1) / 2; k++) {
+            // Tricomiの漸近式による初期値
+            auto xk = (1.0L - (nl - 1.0L) / (8.0L * nl * nl * nl)) * std::cos(PI * (static_cast<long double>(k) - 0.25L) / (nl + 0.5L));
+            auto dp = 0.0L;
+            for (auto iter = 0; iter < 100; iter++) {
+                auto const dx = legendre(n, xk, dp) / dp;
+                xk -= dx;
+                if (std::fabs(dx) <= 1.0E-19L) {
+                    break;
+                }
+            }
+
+            legendre(n, xk, dp);
+            auto const wk = 2.0L / ((1.0L - xk * xk) * dp * dp);
+            x[n - k] = static_cast<double>(xk);
+            w[n - k] = static_cast<double>(wk);
+            x[k - 1] = static_cast<double>(-xk);
+            w[k - 1] = static_cast<double>(wk);
+        }
+
+        if (n & 0x01) {
+            x[n / 2] = 0.0;
+        }
+    }
+
+    //! A function.
+    /*!
+        二組の節と重みの差の最大値を求める
+        \param x 節
+        \param w 重み
+        \param xref 比較する節
+        \param wref 比較する重み
+        \return 節の絶対誤差と重みの相対誤差の最大値
+    */
+    inline Error maxError(std::vector<double> const & x, std::vector<double> const & w, std::vector<double> const & xref, std::vector<double> const & wref)
+    {
+        Error error = { 0.0, 0.0 };
+        for (auto i = 0U; i < x.size(); i++) {
+            error.x = std::max(error.x, std::fabs(x[i] - xref[i]));
+            error.w = std::max(error.w, std::fabs(w[i] - wref[i]) / wref[i]);
+        }
+
+        return error;
+    }
+}
+
+#endif  // _REFERENCE_H_
@@ -0,0 +1,80 @@
+﻿/*! \file rulefile_test.cpp
+    \brief Gauss_Legendre::saveで、自分がマップしているファイルに上書き保存しても壊れないことを確かめるテスト
+
+    Copyright ©  2014 @dc1394 All Rights Reserved.
+*/
+#include "Gauss_Legendre.h"
+#include <cmath>        // for std::exp
+#include <cstdint>      // for std::uint32_t
+#include <cstdio>       // for std::remove
+#include <exception>    // for std::exception
+#include <iostream>     // for std::cout
+#include <string>       // for std::string
+
+namespace {
+    //! A global variable (constant).
+    /*!
+        保存するテーブルの分点（ページを何枚もまたぐ大きさ）
+    */
+    static auto constexpr N = 20001U;
+
+    //! A global variable (constant).
+    /*!
+        テーブルを保存するファイルのパス
+    */
+    static char const PATH[] = "rulefile_test.glr";
+
+    //! A function.
+    /*!
+        exp(x)を[0, 1]で積分する
+        \param gl Gauss-Legendreの積分のオブジェクト
+        \return 積分値
+    */
+    double integrate(gausslegendre::Gauss_Legendre const & gl)
+    {
+        return gl.qgauss(myfunctional::make_functional([](double x) { return std::exp(x); }), 0.0, 1.0);
+    }
+
+    //! A function.
+    /*!
+        ファイルをマップしたオブジェクトで、同じファイルに上書き保存してから積分する
+        \return 上書き保存の前後とファイルの読み直しで、積分値が一致すればtrue
+    */
+    bool testSaveOverSelf()
+    {
+        gausslegendre::Gauss_Legendre(N).save(PATH);
+
+        gausslegendre::Gauss_Legendre const mapped(PATH, N);
+        auto const before = integrate(mapped);
+
+        // ファイルをその場で書き換えると、ここでmappedの領域が切り詰められる（POSIXではSIGBUS）
+        mapped.save(PATH);
+        auto const after = integrate(mapped);
+
+        gausslegendre::Gauss_Legendre const reloaded(PATH, N, gausslegendre::Kernel::Auto, gausslegendre::Summation::Naive, gausslegendre::Storage::Full, gausslegendre::Execution::Sequential, true);
+        auto const reread = integrate(reloaded);
+
+        if (before == after && before == reread) {
+            return true;
+        }
+
+        std::cout << "上書き保存の前 = " << before << ", 後 = " << after << ", 読み直し = " << reread << std::endl;
+        return false;
+    }
+}
+
+int main()
+{
+    auto ok = false;
+    try {
+        ok = testSaveOverSelf();
+    }
+    catch (std::exception const & e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    std::remove(PATH);
+
+    std::cout << (ok ? "OK" : "NG") << std::endl;
+    return ok ? 0 : 1;
+}